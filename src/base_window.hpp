@@ -209,6 +209,29 @@ along with Anaconda.  If not, see <http://www.gnu.org/licenses/>.)");
 		}
 	}
 
+	// Runs the benchmark as a low priority job so the UI doesn't stall while
+	// it loads and decodes every bank, the results are logged when it's done.
+	static void benchmark_menu_item(const char *label,
+	                                se::job_ptr_t &job,
+	                                void (*benchmark)(se::game_t &,
+	                                                  const se::job_ptr_t &))
+	{
+		const bool running = job && !job->finished();
+		char progress[8]   = {};
+		if (running)
+			std::snprintf(
+			  progress, sizeof(progress), "%d%%", (int)(job->progress() * 100));
+		if (ImGui::MenuItem(label,
+		                    running ? progress : nullptr,
+		                    false,
+		                    SrcExp.loaded && !running))
+			job = se::scheduler().submit(label,
+			                             se::job_priority_t::low,
+			                             false,
+			                             [benchmark](const se::job_ptr_t &self)
+			                             { benchmark(SrcExp.state, self); });
+	}
+
 	static void debug_menu()
 	{
 		if (ImGui::BeginMenu("Debug"))
@@ -220,6 +243,22 @@ along with Anaconda.  If not, see <http://www.gnu.org/licenses/>.)");
 				ImGui::Checkbox("Only errors", &lak::debugger.live_errors_only);
 				ImGui::Checkbox("Developer mode", &lak::debugger.line_info_enabled);
 			}
+			if (SrcExp.loaded)
+			{
+				const auto stats = SrcExp.state.decode_context->cache.stats();
+				ImGui::Text("Decode cache: %zu hits, %zu misses, %zu evictions",
+				            stats.hits,
+				            stats.misses,
+				            stats.evictions);
+				ImGui::Text("Decode cache: %zu entries, %zu KiB",
+				            stats.entries,
+				            stats.bytes / 1024);
+			}
+			static se::job_ptr_t inflate_job;
+			benchmark_menu_item(
+			  "Benchmark inflate", inflate_job, &se::BenchmarkInflate);
+			static se::job_ptr_t lz4_job;
+			benchmark_menu_item("Benchmark LZ4", lz4_job, &se::BenchmarkLZ4);
 			ImGui::EndMenu();
 		}
 	}
@@ -816,10 +855,11 @@ along with Anaconda.  If not, see <http://www.gnu.org/licenses/>.)");
 	static bool crypto()
 	{
 		bool updated   = false;
-		int magic_char = se::_magic_char;
+		auto &context  = *SrcExp.state.decode_context;
+		int magic_char = context.magic_char();
 		if (ImGui::InputInt("Magic Char (u8)", &magic_char))
 		{
-			se::_magic_char = static_cast<uint8_t>(magic_char);
+			context.set_magic_char(static_cast<uint8_t>(magic_char));
 			se::GetEncryptionKey(SrcExp.state);
 			updated = true;
 		}
@@ -874,6 +914,21 @@ along with Anaconda.  If not, see <http://www.gnu.org/licenses/>.)");
 		}
 	}
 
+	// The EXE view edits the game file's (copy-on-write) mapping directly,
+	// which has to know so it never releases the edited pages. Anything
+	// decoded from the edited byte is dropped from the decode cache.
+	static void write_exe_byte(ImU8 *data, size_t off, ImU8 d)
+	{
+		data[off] = d;
+		if (SrcExp.state.decode_context)
+			SrcExp.state.decode_context->cache.invalidate(
+			  reinterpret_cast<const byte_t *>(data + off),
+			  reinterpret_cast<const byte_t *>(data + off + 1));
+		if (SrcExp.state.file && SrcExp.state.file->mapping() &&
+		    data == reinterpret_cast<ImU8 *>(SrcExp.state.file->data()))
+			SrcExp.state.file->mapping()->mark_written(off, 1);
+	}
+
 	static void memory_explorer(bool &update)
 	{
 		if (!SrcExp.state.file) return;
@@ -905,6 +960,7 @@ along with Anaconda.  If not, see <http://www.gnu.org/licenses/>.)");
 		{
 			SrcExp.binary_block.attempt |= ImGui::Button("Save Binary");
 			ImGui::SameLine();
+			SrcExp.editor.WriteFn = &write_exe_byte;
 			memory_explorer_impl(
 			  SrcExp.editor, content_mode, *SrcExp.state.file, update);
 
@@ -972,10 +1028,16 @@ along with Anaconda.  If not, see <http://www.gnu.org/licenses/>.)");
 			if (content_mode == VIEW_DATA_BINARY && update)
 				SrcExp.editor.GotoAddrAndHighlight(0, 0);
 		}
-		else if (data_mode == 3) // _magic_key
+		else if (data_mode == 3) // magic_key
 		{
-			SrcExp.editor.DrawContents(&(se::_magic_key[0]), se::_magic_key.size());
+			// The editor works on a copy, edits are handed back as a new key.
+			auto &context      = *SrcExp.state.decode_context;
+			const auto old_key = context.magic_key();
+			auto magic_key     = old_key;
+			SrcExp.editor.DrawContents(magic_key.data(), magic_key.size());
 			if (update) SrcExp.editor.GotoAddrAndHighlight(0, 0);
+			if (!std::equal(magic_key.begin(), magic_key.end(), old_key.begin()))
+				context.set_magic_key(lak::move(magic_key));
 		}
 
 		last   = SrcExp.view;
@@ -47,9 +47,8 @@ struct binary_analysis_window : public base_window<binary_analysis_window>
 			  {
 				  lak::debugger.clear();
 				  SrcExp.state      = se::game_t{};
-				  SrcExp.state.file = se::make_data_ref_ptr(
-				    se::data_ref_ptr_t{},
-				    lak::read_file(exe_path).EXPECT("failed to load file"));
+				  SrcExp.state.file =
+				    se::LoadFile(exe_path).EXPECT("failed to load file");
 				  ASSERT(!!SrcExp.state.file);
 				  DEBUG("File size: ", SrcExp.state.file->size());
 				  SrcExp.loaded       = true;
@@ -12,7 +12,13 @@ namespace SourceExplorer
 
 		const auto start = strm.position();
 
-		old = game.old_game;
+		// ID, mode, size and up to two more sizes, the data itself is counted
+		// by read_ref_span.
+		strm.touch(16);
+
+		old      = game.old_game;
+		context  = game.decode_context.get();
+		is_chunk = true;
 		TRY_ASSIGN(ID = (chunk_t), strm.read_u16());
 		TRY_ASSIGN(mode = (encoding_t), strm.read_u16());
 
@@ -25,7 +31,7 @@ namespace SourceExplorer
 		DEBUG("Root Position: ", strm_ref_span.root_position().UNWRAP());
 
 		if ((mode == encoding_t::mode2 || mode == encoding_t::mode3) &&
-		    _magic_key.size() < 256)
+		    !context->has_magic_key())
 			GetEncryptionKey(game);
 
 		TRY_ASSIGN(const auto chunk_size =, strm.read_u32());
@@ -107,10 +113,32 @@ namespace SourceExplorer
 		if (ImGui::Button("View Memory")) srcexp.view = this;
 	}
 
+	bool lazy_chunk_view(source_explorer_t &,
+	                     chunk_t id,
+	                     const data_ref_span_t &data,
+	                     bool loading)
+	{
+		bool load = false;
+
+		LAK_TREE_NODE("0x%zX %s (%s)##%zX",
+		              (size_t)id,
+		              GetTypeString(id),
+		              loading ? "Loading..." : "Not Loaded",
+		              lak::ok_or_err(data.position().map_err(
+		                [](auto &&) -> size_t { return SIZE_MAX; })))
+		{
+			ImGui::Text("Size: 0x%zX", data.size());
+			if (!loading) load = ImGui::Button("Load");
+		}
+
+		return load;
+	}
+
 	void item_entry_t::read_init(game_t &game)
 	{
-		old  = game.old_game;
-		mode = encoding_t::mode0;
+		old     = game.old_game;
+		mode    = encoding_t::mode0;
+		context = game.decode_context.get();
 	}
 
 	error_t item_entry_t::read_head(game_t &game,
@@ -165,6 +193,8 @@ namespace SourceExplorer
 		DEBUG("Body Expected Size: ", body.expected_size);
 
 		size_t data_size = 0;
+		data_ref_span_t decoded;
+		const size_t generation = context ? context->cache.generation() : 0;
 		if (size)
 		{
 			data_size = *size;
@@ -172,9 +202,9 @@ namespace SourceExplorer
 		else if (game.old_game)
 		{
 			const size_t old_start = strm.position();
-			// Figure out exactly how long the compressed data is
-			// :TODO: It should be possible to figure this out without
-			// actually decompressing it... surely...
+			// Figure out exactly how long the compressed data is. The anaconda
+			// variant of deflate can only be walked by actually decompressing
+			// it, so hand the result to the decode cache for decode_body.
 			RES_TRY_ASSIGN(
 			  const auto raw =,
 			  StreamDecompress(strm, static_cast<unsigned int>(body.expected_size))
@@ -191,6 +221,7 @@ namespace SourceExplorer
 			data_size = strm.position() - old_start;
 			strm.seek(old_start).UNWRAP();
 			DEBUG("Data Size: ", data_size);
+			decoded = raw;
 		}
 		else if (!new_item)
 		{
@@ -206,6 +237,16 @@ namespace SourceExplorer
 		// hack because one of MMF1.5 or tinf_uncompress is a bitch
 		if (game.old_game) mode = encoding_t::mode1;
 
+		// Keyed the same as a full decode_body, which inflates it again if the
+		// cache has dropped it by then.
+		if (context && decoded._source)
+			context->cache.insert(
+			  body.data,
+			  {body.data.data(), body.data.size(), ID, mode, old, false, SIZE_MAX},
+			  decoded.ref_subspan(
+			    0, std::min(decoded.size(), size_t(body.expected_size))),
+			  generation);
+
 		return lak::ok_t{};
 	}
 
@@ -218,6 +259,8 @@ namespace SourceExplorer
 		MEMBER_FUNCTION_CHECKPOINT();
 
 		const auto start = strm.position();
+		// The handle and sizes around the head and body.
+		strm.touch(header_size + 12);
 		read_init(game);
 		RES_TRY(read_head(game, strm, header_size, has_handle));
 		RES_TRY(read_body(game, strm, compressed));
@@ -259,6 +302,17 @@ namespace SourceExplorer
 	}
 
 	result_t<data_ref_span_t> basic_entry_t::decode_body(size_t max_size) const
+	{
+		if (!context) return decode_body_uncached(max_size);
+
+		return context->cache.get_or_decode(
+		  body.data,
+		  {body.data.data(), body.data.size(), ID, mode, old, false, max_size},
+		  [&] { return decode_body_uncached(max_size); });
+	}
+
+	result_t<data_ref_span_t> basic_entry_t::decode_body_uncached(
+	  size_t max_size) const
 	{
 		MEMBER_FUNCTION_CHECKPOINT();
 
@@ -285,7 +339,8 @@ namespace SourceExplorer
 						return Inflate(body.data,
 						               true,
 						               true,
-						               std::min(body.expected_size, max_size))
+						               std::min(body.expected_size, max_size),
+						               body.expected_size)
 						  .RES_ADD_TRACE("MODE1 Failed To Inflate")
 						  .if_ok([](const auto &ref_span)
 						         { DEBUG("Size: ", ref_span.size()); });
@@ -308,7 +363,7 @@ namespace SourceExplorer
 			{
 				case encoding_t::mode4:
 				{
-					return LZ4DecodeReadSize(body.data)
+					return LZ4DecodeReadSize(body.data, max_size)
 					  .RES_ADD_TRACE("LZ4 Decode Failed")
 					  .if_ok([](const auto &ref_span)
 					         { DEBUG("Size: ", ref_span.size()); });
@@ -318,7 +373,7 @@ namespace SourceExplorer
 					[[fallthrough]];
 				case encoding_t::mode2:
 				{
-					return Decrypt(body.data, ID, mode)
+					return Decrypt(body.data, ID, mode, context, max_size)
 					  .RES_ADD_TRACE("MODE2/3 Failed To Decrypt")
 					  .if_ok([](const auto &ref_span)
 					         { DEBUG("Size: ", ref_span.size()); });
@@ -326,7 +381,8 @@ namespace SourceExplorer
 
 				case encoding_t::mode1:
 				{
-					return Inflate(body.data, false, false, max_size)
+					return Inflate(
+					         body.data, false, false, max_size, body.expected_size)
 					  .RES_ADD_TRACE("MODE1 Failed To Inflate")
 					  .if_ok([](const auto &ref_span)
 					         { DEBUG("Size: ", ref_span.size()); });
@@ -336,10 +392,11 @@ namespace SourceExplorer
 					[[fallthrough]];
 				default:
 				{
-					if (body.data.size() > 0 && uint8_t(body.data[0]) == 0x78)
+					if (looks_compressed(body, false))
 					{
 						return lak::ok_t{lak::ok_or_err(
-						  Inflate(body.data, false, false, max_size)
+						  Inflate(
+						    body.data, false, false, max_size, body.expected_size)
 						    .if_ok(
 						      [](const auto &ref_span)
 						      {
@@ -351,6 +408,8 @@ namespace SourceExplorer
 						      [this](const auto &err)
 						      {
 							      WARNING("Guess MODE1 Failed To Inflate: ", err);
+							      if (is_chunk && context)
+								      context->set_chunk_compression(ID, false, false);
 							      DEBUG("Size: ", body.data.size());
 							      return body.data;
 						      }))};
@@ -364,7 +423,40 @@ namespace SourceExplorer
 		}
 	}
 
+	bool basic_entry_t::looks_compressed(const data_point_t &point,
+	                                     bool head) const
+	{
+		if (!is_chunk || !context) return LooksCompressed(point.data);
+
+		// Chunks that don't even start like a zlib stream say nothing about
+		// the rest of their type.
+		if (point.data.size() == 0 || uint8_t(point.data[0]) != 0x78)
+			return false;
+
+		// Only a type known to be compressed skips the check. A type that has
+		// held uncompressed data can still hold a real zlib stream, and the
+		// check is cheap next to the inflate it decides on.
+		if (context->chunk_compression(ID, head) ==
+		    decode_context_t::compression_t::compressed)
+			return true;
+
+		const bool result = LooksCompressed(point.data);
+		context->set_chunk_compression(ID, head, result);
+		return result;
+	}
+
 	result_t<data_ref_span_t> basic_entry_t::decode_head(size_t max_size) const
+	{
+		if (!context) return decode_head_uncached(max_size);
+
+		return context->cache.get_or_decode(
+		  head.data,
+		  {head.data.data(), head.data.size(), ID, mode, old, true, max_size},
+		  [&] { return decode_head_uncached(max_size); });
+	}
+
+	result_t<data_ref_span_t> basic_entry_t::decode_head_uncached(
+	  size_t max_size) const
 	{
 		MEMBER_FUNCTION_CHECKPOINT();
 
@@ -393,7 +485,7 @@ namespace SourceExplorer
 				{
 					// :TODO: this was originally body not head, check that this change
 					// is correct.
-					return Decrypt(head.data, ID, mode)
+					return Decrypt(head.data, ID, mode, context, max_size)
 					  .RES_ADD_TRACE("MODE2/3 Failed To Decrypt")
 					  .if_ok([](const auto &ref_span)
 					         { DEBUG("Size: ", ref_span.size()); });
@@ -401,7 +493,8 @@ namespace SourceExplorer
 
 				case encoding_t::mode1:
 				{
-					return Inflate(head.data, false, false, max_size)
+					return Inflate(
+					         head.data, false, false, max_size, head.expected_size)
 					  .RES_ADD_TRACE("MODE1 Failed To Inflate")
 					  .if_ok([](const auto &ref_span)
 					         { DEBUG("Size: ", ref_span.size()); });
@@ -413,10 +506,11 @@ namespace SourceExplorer
 					[[fallthrough]];
 				default:
 				{
-					if (head.data.size() > 0 && uint8_t(head.data[0]) == 0x78)
+					if (looks_compressed(head, true))
 					{
 						return lak::ok_t{lak::ok_or_err(
-						  Inflate(head.data, false, false, max_size)
+						  Inflate(
+						    head.data, false, false, max_size, head.expected_size)
 						    .if_ok(
 						      [](const auto &ref_span)
 						      {
@@ -428,6 +522,8 @@ namespace SourceExplorer
 						      [this](const auto &err)
 						      {
 							      WARNING("Guess MODE1 Failed To Inflate: ", err);
+							      if (is_chunk && context)
+								      context->set_chunk_compression(ID, true, false);
 							      DEBUG("Size: ", head.data.size());
 							      return head.data;
 						      }))};
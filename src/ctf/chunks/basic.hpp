@@ -2,6 +2,10 @@
 #define SRCEXP_CTF_CHUNKS_BASIC_HPP
 
 #include "../common.hpp"
+#include "../scheduler.hpp"
+
+#include <atomic>
+#include <mutex>
 
 namespace SourceExplorer
 {
@@ -14,11 +18,16 @@ namespace SourceExplorer
 		};
 		encoding_t mode;
 		bool old;
+		// Whether ID is a chunk ID rather than an item handle.
+		bool is_chunk = false;
 
 		data_ref_span_t ref_span;
 		data_point_t head;
 		data_point_t body;
 
+		// Owned by the game this entry was read from.
+		decode_context_t *context = nullptr;
+
 		size_t position() const
 		{
 			return lak::ok_or_err(ref_span.position().map_err([](auto &&) -> size_t
@@ -27,8 +36,17 @@ namespace SourceExplorer
 
 		const data_ref_span_t &raw_head() const;
 		const data_ref_span_t &raw_body() const;
+		// These go through the game's decode cache.
 		result_t<data_ref_span_t> decode_head(size_t max_size = SIZE_MAX) const;
 		result_t<data_ref_span_t> decode_body(size_t max_size = SIZE_MAX) const;
+
+	private:
+		result_t<data_ref_span_t> decode_head_uncached(size_t max_size) const;
+		result_t<data_ref_span_t> decode_body_uncached(size_t max_size) const;
+
+		// Whether unencoded data is worth trying to inflate. For chunks the
+		// answer is remembered per chunk type in context.
+		bool looks_compressed(const data_point_t &point, bool head) const;
 	};
 
 	struct chunk_entry_t : public basic_entry_t
@@ -77,6 +95,183 @@ namespace SourceExplorer
 		error_t read(game_t &game, data_reader_t &strm);
 		error_t basic_view(source_explorer_t &srcexp, const char *name) const;
 	};
+
+	extern bool lazy_load_banks;
+	extern bool parallel_load_banks;
+	// Dump images, sounds and music while their (lazy) banks are being read.
+	extern bool stream_dumps;
+
+	// Draws the tree node for a chunk that hasn't been read yet, returns true
+	// if the user asked for it to be loaded.
+	bool lazy_chunk_view(source_explorer_t &srcexp,
+	                     chunk_t id,
+	                     const data_ref_span_t &data,
+	                     bool loading);
+
+	// A chunk_ptr that can be skimmed over while reading the game header and
+	// is only read the first time it is accessed.
+	template<typename T>
+	struct lazy_chunk_ptr : public chunk_ptr<T>
+	{
+		using read_func_t = error_t (T::*)(game_t &, data_reader_t &);
+
+	private:
+		struct lazy_state_t
+		{
+			std::mutex mutex;
+			std::atomic_bool pending = true;
+			// Set once ready() has queued the chunk to be read.
+			std::atomic_bool queued = false;
+			// Set while a thread is reading the chunk.
+			std::atomic_bool reading = false;
+			game_t *game;
+			data_ref_span_t data;
+			chunk_t id;
+			read_func_t read_func;
+		};
+
+		lak::unique_ptr<lazy_state_t> _lazy;
+
+	public:
+		using chunk_ptr<T>::operator=;
+
+		// Record where the chunk is so it can be read on first access.
+		void defer(game_t &game,
+		           data_ref_span_t data,
+		           chunk_t id,
+		           read_func_t read_func = &T::read)
+		{
+			this->ptr = lak::unique_ptr<T>();
+			_lazy            = lak::unique_ptr<lazy_state_t>::make();
+			_lazy->game      = &game;
+			_lazy->data      = data;
+			_lazy->id        = id;
+			_lazy->read_func = read_func;
+		}
+
+		bool is_loaded() const
+		{
+			return !_lazy || !_lazy->pending.load(std::memory_order_acquire);
+		}
+
+		bool is_loading() const
+		{
+			return !is_loaded() && (_lazy->queued || _lazy->reading);
+		}
+
+		// Check if the chunk exists without loading it.
+		bool is_present() const { return !is_loaded() || this->ptr; }
+
+		// For the UI thread, which mustn't wait on a chunk that is being read
+		// (with --stream-dumps that includes waiting for the dumps to catch up).
+		// Returns true if the chunk has been read, otherwise queues it to be read
+		// on the scheduler and returns false so the caller can show it loading.
+		bool ready() const
+		{
+			if (is_loaded()) return true;
+			if (!_lazy->queued.exchange(true))
+				scheduler().submit(
+				  "Load chunk",
+				  job_priority_t::high,
+				  false,
+				  [this](const job_ptr_t &)
+				  {
+					  // Whoever already holds the lock is reading it.
+					  std::unique_lock lock(_lazy->mutex, std::try_to_lock);
+					  if (lock)
+						  read(lock, [](bool) {})
+						    .IF_ERR("Failed To Load Chunk")
+						    .discard();
+				  });
+			return false;
+		}
+
+		// Read the chunk if it was deferred. Only the first call reports the
+		// read error, the (possibly partially read) chunk is kept regardless.
+		error_t load() const
+		{
+			return load([](bool) {});
+		}
+
+		// Same as load, but calls reading(true) just before this thread reads
+		// the chunk and reading(false) once it's done, both under the chunk's
+		// lock. Neither is called if the chunk has already been read.
+		template<typename FUNC>
+		error_t load(FUNC &&reading) const
+		{
+			if (is_loaded()) return lak::ok_t{};
+
+			std::unique_lock lock(_lazy->mutex);
+			return read(lock, reading);
+		}
+
+		// Doesn't block the UI thread, a chunk that hasn't been read yet is only
+		// queued to be read once the user asks for it.
+		template<typename... ARGS>
+		error_t view(source_explorer_t &srcexp, ARGS &&...args) const
+		{
+			if (!is_loaded())
+			{
+				if (lazy_chunk_view(srcexp, _lazy->id, _lazy->data, is_loading()))
+					ready();
+				return lak::ok_t{};
+			}
+			return chunk_ptr<T>::view(srcexp, args...);
+		}
+
+		operator bool() const
+		{
+			load().IF_ERR("Failed To Load Chunk").discard();
+			return static_cast<bool>(this->ptr);
+		}
+
+		auto *operator->()
+		{
+			load().IF_ERR("Failed To Load Chunk").discard();
+			return this->ptr.get();
+		}
+		auto *operator->() const
+		{
+			load().IF_ERR("Failed To Load Chunk").discard();
+			return this->ptr.get();
+		}
+
+		auto &operator*()
+		{
+			load().IF_ERR("Failed To Load Chunk").discard();
+			return *this->ptr;
+		}
+		auto &operator*() const
+		{
+			load().IF_ERR("Failed To Load Chunk").discard();
+			return *this->ptr;
+		}
+
+	private:
+		// Reads the chunk if it's still pending, lock must be holding its mutex.
+		template<typename FUNC>
+		error_t read(const std::unique_lock<std::mutex> &lock,
+		             FUNC &&reading) const
+		{
+			ASSERT(lock.owns_lock());
+			if (!_lazy->pending.load(std::memory_order_relaxed))
+				return lak::ok_t{};
+
+			_lazy->reading = true;
+			reading(true);
+			DEFER(reading(false));
+			DEFER(_lazy->reading = false);
+			DEFER(_lazy->pending.store(false, std::memory_order_release));
+
+			// The chunk is only logically const until it has been read.
+			auto &ptr = const_cast<lak::unique_ptr<T> &>(this->ptr);
+			ptr       = lak::unique_ptr<T>::make();
+
+			data_reader_t strm(_lazy->data);
+			return (ptr.get()->*_lazy->read_func)(*_lazy->game, strm)
+			  .RES_ADD_TRACE("lazy_chunk_ptr::load");
+		}
+	};
 }
 
 #endif
@@ -103,10 +103,14 @@ namespace SourceExplorer
 
 		error_t object_instance_t::view(source_explorer_t &srcexp) const
 		{
+			// Don't wait on the object bank if it's still being read.
+			const bool objects_ready = srcexp.state.game.object_bank.ready();
+
 			lak::u8string str;
-			auto obj = GetObject(srcexp.state, handle);
-			if (obj.is_ok() && obj.unwrap().name)
-				str += lak::to_u8string(obj.unwrap().name->value);
+			object::item_t *obj =
+			  objects_ready ? lak::as_ptr(GetObject(srcexp.state, handle).ok())
+			                : nullptr;
+			if (obj && obj->name) str += lak::to_u8string(obj->name->value);
 
 			LAK_TREE_NODE("0x%zX %s##%zX", (size_t)handle, str.c_str(), (size_t)info)
 			{
@@ -121,15 +125,18 @@ namespace SourceExplorer
 				ImGui::Text("Layer: 0x%zX", (size_t)layer);
 				ImGui::Text("Unknown: 0x%zX", (size_t)unknown);
 
-				if (obj.is_ok())
+				if (obj)
 				{
-					RES_TRY(obj.unwrap().view(srcexp).RES_ADD_TRACE(
-					  "frame::object_instance_t::view"));
+					RES_TRY(
+					  obj->view(srcexp).RES_ADD_TRACE("frame::object_instance_t::view"));
 				}
+				else if (!objects_ready)
+					ImGui::Text("Object Bank Loading...");
 
 				switch (parent_type)
 				{
 					case object_parent_type_t::frame_item:
+						if (!objects_ready) break;
 						if (auto parent_obj = GetObject(srcexp.state, parent_handle);
 						    parent_obj.is_ok())
 						{
@@ -731,6 +738,19 @@ namespace SourceExplorer
 			return lak::ok_t{};
 		}
 
+		error_t bank_t::read_frames(game_t &game, data_reader_t &strm)
+		{
+			MEMBER_FUNCTION_CHECKPOINT();
+
+			while (strm.remaining().size() >= 2 &&
+			       (chunk_t)strm.peek_u16().UNWRAP() == chunk_t::frame)
+			{
+				if (items.emplace_back().read(game, strm).is_err()) break;
+			}
+
+			return lak::ok_t{};
+		}
+
 		error_t bank_t::view(source_explorer_t &srcexp) const
 		{
 			LAK_TREE_NODE("0x%zX Frame Bank (%zu Items)##%zX",
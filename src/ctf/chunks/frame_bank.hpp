@@ -198,6 +198,8 @@ namespace SourceExplorer
 			lak::array<item_t> items;
 
 			error_t read(game_t &game, data_reader_t &strm);
+			// Reads a run of frame chunks that aren't preceded by a bank chunk.
+			error_t read_frames(game_t &game, data_reader_t &strm);
 			error_t view(source_explorer_t &srcexp) const;
 		};
 	}
@@ -1,6 +1,9 @@
 #include "header.hpp"
 
 #include "../explorer.hpp"
+#include "../scheduler.hpp"
+
+#include <mutex>
 
 namespace SourceExplorer
 {
@@ -17,6 +20,56 @@ namespace SourceExplorer
 			return chunk->read(game, strm);
 		};
 
+		// Skims over a bank (and any trailing chunks that belong to it) so it
+		// can be read the first time it is accessed.
+		auto defer_bank = [&](auto &chunk,
+		                      lak::optional<chunk_t> trailing_id,
+		                      bool repeated_trailing = false) -> error_t
+		{
+			const auto start = strm.position();
+			const auto id    = (chunk_t)strm.peek_u16().UNWRAP();
+
+			// Frame banks can be headless (just a run of frame chunks).
+			const bool headless = trailing_id && id == *trailing_id;
+
+			if (!headless)
+			{
+				chunk_entry_t skimmed;
+				RES_TRY(skimmed.read(game, strm).RES_ADD_TRACE("header_t::read"));
+			}
+
+			while (trailing_id && strm.remaining().size() >= 2 &&
+			       (chunk_t)strm.peek_u16().UNWRAP() == *trailing_id)
+			{
+				chunk_entry_t skimmed;
+				RES_TRY(skimmed.read(game, strm).RES_ADD_TRACE("header_t::read"));
+				if (!repeated_trailing) break;
+			}
+
+			const auto end = strm.position();
+			TRY(strm.seek(start));
+			RES_TRY_ASSIGN(
+			  auto data =,
+			  strm.read_ref_span(end - start).RES_MAP_TO_TRACE("header_t::read"));
+
+			using bank_t =
+			  typename std::remove_reference_t<decltype(chunk)>::value_type;
+			if constexpr (std::is_same_v<bank_t, frame::bank_t>)
+			{
+				if (headless)
+				{
+					chunk.defer(game, data, id, &frame::bank_t::read_frames);
+					return lak::ok_t{};
+				}
+			}
+
+			chunk.defer(game, data, id);
+			return lak::ok_t{};
+		};
+
+		// Parallel loading needs to know where each bank is up front.
+		const bool defer_banks = lazy_load_banks || parallel_load_banks;
+
 		chunk_t childID  = (chunk_t)-1;
 		size_t start_pos = SIZE_MAX;
 		for (bool not_finished = true; not_finished;)
@@ -224,19 +277,28 @@ namespace SourceExplorer
 					break;
 
 				case chunk_t::frame_bank:
-					RES_TRY(init_chunk(frame_bank).RES_ADD_TRACE("header_t::read"));
+					if (defer_banks)
+					{
+						RES_TRY(defer_bank(frame_bank, chunk_t::frame, true));
+					}
+					else
+					{
+						RES_TRY(init_chunk(frame_bank).RES_ADD_TRACE("header_t::read"));
+					}
 					break;
 
 				case chunk_t::frame:
-					if (!frame_bank)
-						frame_bank = lak::unique_ptr<frame::bank_t>::make();
-					else
+					if (frame_bank.is_present())
 						ERROR("Frame Bank Already Exists");
-					while (strm.remaining().size() >= 2 &&
-					       (chunk_t)strm.peek_u16().UNWRAP() == chunk_t::frame)
+					if (defer_banks)
+					{
+						RES_TRY(defer_bank(frame_bank, chunk_t::frame, true));
+					}
+					else
 					{
-						if (frame_bank->items.emplace_back().read(game, strm).is_err())
-							break;
+						if (!frame_bank.is_present())
+							frame_bank = lak::unique_ptr<frame::bank_t>::make();
+						RES_TRY(frame_bank->read_frames(game, strm));
 					}
 					break;
 
@@ -246,23 +308,58 @@ namespace SourceExplorer
 
 				case chunk_t::object_bank:
 				case chunk_t::object_bank2:
-					RES_TRY(init_chunk(object_bank).RES_ADD_TRACE("header_t::read"));
+					if (defer_banks)
+					{
+						RES_TRY(defer_bank(object_bank, lak::nullopt));
+					}
+					else
+					{
+						RES_TRY(init_chunk(object_bank).RES_ADD_TRACE("header_t::read"));
+					}
 					break;
 
 				case chunk_t::image_bank:
-					RES_TRY(init_chunk(image_bank).RES_ADD_TRACE("header_t::read"));
+					if (defer_banks)
+					{
+						RES_TRY(defer_bank(image_bank, chunk_t::image_handles));
+					}
+					else
+					{
+						RES_TRY(init_chunk(image_bank).RES_ADD_TRACE("header_t::read"));
+					}
 					break;
 
 				case chunk_t::sound_bank:
-					RES_TRY(init_chunk(sound_bank).RES_ADD_TRACE("header_t::read"));
+					if (defer_banks)
+					{
+						RES_TRY(defer_bank(sound_bank, chunk_t::sound_handles));
+					}
+					else
+					{
+						RES_TRY(init_chunk(sound_bank).RES_ADD_TRACE("header_t::read"));
+					}
 					break;
 
 				case chunk_t::music_bank:
-					RES_TRY(init_chunk(music_bank).RES_ADD_TRACE("header_t::read"));
+					if (defer_banks)
+					{
+						RES_TRY(defer_bank(music_bank, chunk_t::music_handles));
+					}
+					else
+					{
+						RES_TRY(init_chunk(music_bank).RES_ADD_TRACE("header_t::read"));
+					}
 					break;
 
 				case chunk_t::font_bank:
-					RES_TRY(init_chunk(font_bank).RES_ADD_TRACE("header_t::read"));
+					if (defer_banks)
+					{
+						RES_TRY(defer_bank(font_bank, chunk_t::font_handles));
+					}
+					else
+					{
+						RES_TRY(init_chunk(font_bank).RES_ADD_TRACE("header_t::read"));
+					}
 					break;
 
 				case chunk_t::fusion_3_seed:
@@ -284,9 +381,63 @@ namespace SourceExplorer
 			}
 		}
 
+		if (parallel_load_banks)
+		{
+			RES_TRY(load_banks(game).RES_ADD_TRACE("header_t::read"));
+		}
+
 		return lak::ok_t{};
 	}
 
+	error_t header_t::load_banks(game_t &game)
+	{
+		FUNCTION_CHECKPOINT();
+
+		// The banks might decrypt chunks from multiple threads at once.
+		PrepareDecryption(game);
+
+		std::mutex errors_mutex;
+		lak::array<lak::stack_trace> errors;
+
+		auto job = scheduler().submit(
+		  "Load banks",
+		  job_priority_t::high,
+		  true,
+		  [&](const job_ptr_t &job)
+		  {
+			  auto load_bank = [&](const auto &bank)
+			  {
+				  if (bank.is_loaded()) return;
+				  scheduler().spawn(job,
+				                    [&](const job_ptr_t &)
+				                    {
+					                    bank.load().if_err(
+					                      [&](const auto &err)
+					                      {
+						                      std::lock_guard lock(errors_mutex);
+						                      errors.push_back(err);
+					                      });
+				                    });
+			  };
+
+			  // Roughly largest to smallest, so the big banks start first.
+			  load_bank(image_bank);
+			  load_bank(sound_bank);
+			  load_bank(music_bank);
+			  load_bank(frame_bank);
+			  load_bank(object_bank);
+			  load_bank(font_bank);
+		  });
+
+		scheduler().wait(*job);
+
+		if (errors.empty()) return lak::ok_t{};
+
+		for (size_t i = 1; i < errors.size(); ++i) ERROR(errors[i]);
+
+		return lak::err_t{lak::move(errors[0])};
+	}
+
 	error_t header_t::view(source_explorer_t &srcexp) const
 	{
 		LAK_TREE_NODE("0x%zX Game Header##%zX", (size_t)entry.ID, entry.position())
@@ -94,12 +94,12 @@ namespace SourceExplorer
 
 		chunk_ptr<bank_offsets_t> bank_offsets;
 		chunk_ptr<frame::handles_t> frame_handles;
-		chunk_ptr<frame::bank_t> frame_bank;
-		chunk_ptr<object::bank_t> object_bank;
-		chunk_ptr<image::bank_t> image_bank;
-		chunk_ptr<sound::bank_t> sound_bank;
-		chunk_ptr<music::bank_t> music_bank;
-		chunk_ptr<font::bank_t> font_bank;
+		lazy_chunk_ptr<frame::bank_t> frame_bank;
+		lazy_chunk_ptr<object::bank_t> object_bank;
+		lazy_chunk_ptr<image::bank_t> image_bank;
+		lazy_chunk_ptr<sound::bank_t> sound_bank;
+		lazy_chunk_ptr<music::bank_t> music_bank;
+		lazy_chunk_ptr<font::bank_t> font_bank;
 
 		// Recompiled games (?):
 		chunk_ptr<chunk_2253_t> chunk2253;
@@ -123,6 +123,9 @@ namespace SourceExplorer
 
 		error_t read(game_t &game, data_reader_t &strm);
 		error_t view(source_explorer_t &srcexp) const;
+
+		// Read all of the deferred banks in parallel.
+		error_t load_banks(game_t &game);
 	};
 }
 
@@ -2,6 +2,9 @@
 
 #include "../explorer.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace SourceExplorer
 {
 	namespace image
@@ -298,31 +301,17 @@ namespace SourceExplorer
 
 			TRY(strm.seek(data_position));
 
-			if ((flags & image_flag_t::LZX) == image_flag_t::LZX)
+			if (deflated())
 			{
-				if (entry.mode == encoding_t::mode4)
-				{
-					return lak::ok_t{strm.read_remaining_ref_span()};
-				}
-				else
-				{
-					TRY_ASSIGN([[maybe_unused]] const uint32_t decompressed_length =,
-					           strm.read_u32());
-
-					TRY_ASSIGN(const uint32_t compressed_length =, strm.read_u32());
-
-					CHECK_REMAINING(strm, compressed_length);
-
-					return strm.read_ref_span(compressed_length)
-					  .RES_MAP_TO_TRACE("item_t::image_data: read filed")
-					  .map(
-					    [](const data_ref_span_t &ref_span) -> data_ref_span_t
-					    {
-						    return lak::ok_or_err(
-						      Inflate(ref_span, false, false)
-						        .map_err([&](auto &&) { return ref_span; }));
-					    });
-				}
+				uint32_t decompressed_length = 0;
+				return read_deflated(strm, decompressed_length)
+				  .map(
+				    [&](const data_ref_span_t &ref_span) -> data_ref_span_t
+				    {
+					    return lak::ok_or_err(
+					      Inflate(ref_span, false, false, SIZE_MAX, decompressed_length)
+					        .map_err([&](auto &&) { return ref_span; }));
+				    });
 			}
 			else
 			{
@@ -330,6 +319,25 @@ namespace SourceExplorer
 			}
 		}
 
+		bool item_t::deflated() const
+		{
+			return (flags & image_flag_t::LZX) == image_flag_t::LZX &&
+			       entry.mode != encoding_t::mode4;
+		}
+
+		result_t<data_ref_span_t> item_t::read_deflated(
+		  data_reader_t &strm, uint32_t &decompressed_length) const
+		{
+			TRY_ASSIGN(decompressed_length =, strm.read_u32());
+
+			TRY_ASSIGN(const uint32_t compressed_length =, strm.read_u32());
+
+			CHECK_REMAINING(strm, compressed_length);
+
+			return strm.read_ref_span(compressed_length)
+			  .RES_MAP_TO_TRACE("item_t::image_data: read filed");
+		}
+
 		bool item_t::need_palette() const
 		{
 			return graphics_mode == graphics_mode_t::RGB8;
@@ -340,24 +348,99 @@ namespace SourceExplorer
 		{
 			MEMBER_FUNCTION_CHECKPOINT();
 
-			lak::image4_t img = {};
+			lak::image4_t img;
+			img.resize(lak::vec2s_t(size));
+
+			RES_TRY(image_into(lak::span(img.data(), img.contig_size()),
+			                   color_transparent,
+			                   palette)
+			          .RES_ADD_TRACE("image::item_t::image"));
+
+			return lak::move_ok(img);
+		}
+
+		error_t item_t::image_into(lak::span<lak::color4_t> pixels,
+		                           const bool color_transparent,
+		                           const lak::color4_t palette[256]) const
+		{
+			MEMBER_FUNCTION_CHECKPOINT();
+
+			if (pixels.size() != size_t(size.x) * size_t(size.y))
+				return lak::err_t{error(lak::streamify("expected a buffer of ",
+				                                       size.x,
+				                                       "x",
+				                                       size.y,
+				                                       " pixels, got ",
+				                                       pixels.size()))};
+
+			// Short RLE data only leaves a warning, so start from a blank image
+			// like image() always did rather than whatever pixels was holding.
+			std::fill(pixels.begin(), pixels.end(), lak::color4_t{});
+
+			const image_span_t img(pixels, lak::vec2s_t(size));
+
+			const bool rle = (flags & (image_flag_t::RLE | image_flag_t::RLEW |
+			                           image_flag_t::RLET)) != image_flag_t::none;
+			const bool has_alpha_mask =
+			  (flags & image_flag_t::RGBA) == image_flag_t::none &&
+			  (flags & image_flag_t::alpha) != image_flag_t::none;
+
+			// The colour key and opaque alpha are applied as the colours are
+			// decoded, rather than in another pass over the image.
+			alpha_mode_t alpha_mode = alpha_mode_t::opaque;
+			if ((flags & image_flag_t::RGBA) != image_flag_t::none)
+				// we already read the alpha data with the colour data
+				alpha_mode = alpha_mode_t::decoded;
+			else if (has_alpha_mask)
+				// the alpha mask overwrites the alpha anyway
+				alpha_mode = alpha_mode_t::decoded;
+			else if (color_transparent)
+				alpha_mode = alpha_mode_t::transparent;
+
+			if (graphics_mode != graphics_mode_t::JPEG && deflated())
+			{
+				// Decode the pixels straight out of the inflater, so the inflated
+				// image data is never held in full.
+				RES_TRY_ASSIGN(
+				  auto body =,
+				  entry.decode_body().RES_ADD_TRACE("image::item_t::image_into"));
+				data_reader_t strm(body);
+				TRY(strm.seek(data_position));
+				uint32_t decompressed_length = 0;
+				RES_TRY_ASSIGN(auto compressed =,
+				               read_deflated(strm, decompressed_length)
+				                 .RES_ADD_TRACE("image::item_t::image_into"));
+
+				image_decoder_t decoder(img,
+				                        graphics_mode,
+				                        rle,
+				                        padding,
+				                        palette,
+				                        alpha_mode,
+				                        transparent,
+				                        has_alpha_mask,
+				                        alpha_padding);
+				if (InflateImage(compressed, false, decoder).is_ok())
+					return lak::ok_t{};
+
+				// Fall back to image_data, which treats data that fails to inflate
+				// as uncompressed.
+				std::fill(pixels.begin(), pixels.end(), lak::color4_t{});
+			}
 
 			RES_TRY_ASSIGN(auto span =,
-			               image_data().RES_ADD_TRACE("image::item_t::image"));
+			               image_data().RES_ADD_TRACE("image::item_t::image_into"));
 
 			if (graphics_mode == graphics_mode_t::JPEG)
 			{
-				int x, y, n;
-				uint8_t *data =
-				  stbi_load_from_memory(reinterpret_cast<const uint8_t *>(span.data()),
-				                        static_cast<int>(span.size()),
-				                        &x,
-				                        &y,
-				                        &n,
-				                        4);
-				DEFER(stbi_image_free(data));
-
-				if (x != size.x || y != size.y)
+				const auto *jpeg = reinterpret_cast<const uint8_t *>(span.data());
+				const int jpeg_size = static_cast<int>(span.size());
+
+				// Check the size before decoding anything, stb_image can only
+				// decode into a buffer of its own.
+				int x = 0, y = 0, n = 0;
+				if (!stbi_info_from_memory(jpeg, jpeg_size, &x, &y, &n) ||
+				    x != size.x || y != size.y)
 				{
 					return lak::err_t{
 					  error(lak::streamify("jpeg decode failed, expected size (",
@@ -370,53 +453,52 @@ namespace SourceExplorer
 					                       y,
 					                       ")"))};
 				}
-				else
-				{
-					img = lak::image_from_rgba32(reinterpret_cast<const byte_t *>(data),
-					                             lak::vec2s_t{size_t(x), size_t(y)});
-				}
+
+				uint8_t *data = stbi_load_from_memory(jpeg, jpeg_size, &x, &y, &n, 4);
+				DEFER(stbi_image_free(data));
+				if (!data || x != size.x || y != size.y)
+					return lak::err_t{error(u8"jpeg decode failed")};
+
+				std::memcpy(pixels.data(), data, pixels.size() * 4);
 			}
 			else
 			{
 				data_reader_t strm(span);
 
-				img.resize(lak::vec2s_t(size));
-
 				[[maybe_unused]] size_t bytes_read;
-				if ((flags & (image_flag_t::RLE | image_flag_t::RLEW |
-				              image_flag_t::RLET)) != image_flag_t::none)
+				if (rle)
 				{
 					RES_TRY_ASSIGN(bytes_read =,
-					               ReadRLE(strm, img, graphics_mode, padding, palette));
+					               ReadRLE(strm,
+					                       img,
+					                       graphics_mode,
+					                       padding,
+					                       palette,
+					                       alpha_mode,
+					                       transparent));
 				}
 				else
 				{
 					RES_TRY_ASSIGN(bytes_read =,
-					               ReadRGB(strm, img, graphics_mode, padding, palette));
+					               ReadRGB(strm,
+					                       img,
+					                       graphics_mode,
+					                       padding,
+					                       palette,
+					                       alpha_mode,
+					                       transparent));
 				}
 
-				if ((flags & image_flag_t::RGBA) != image_flag_t::none)
-				{
-					// we already read the alpha data with the colour data
-				}
-				else if ((flags & image_flag_t::alpha) != image_flag_t::none)
+				if (has_alpha_mask)
 				{
 					RES_TRY(ReadAlpha(strm, img, alpha_padding));
 				}
-				else if (color_transparent)
-				{
-					ReadTransparent(transparent, img);
-				}
-				else
-				{
-					for (size_t i = 0; i < img.contig_size(); ++i) img[i].a = 255;
-				}
 
 				if (!strm.empty())
 					WARNING(strm.remaining().size(), " Bytes Left Over In Image Data");
 			}
 
-			return lak::move_ok(img);
+			return lak::ok_t{};
 		}
 
 		error_t end_t::view(source_explorer_t &srcexp) const
@@ -465,9 +547,11 @@ namespace SourceExplorer
 
 				for (auto &item : items)
 				{
+					bool item_read = true;
 					RES_TRY(read_item(item).or_else(
 					  [&](const auto &err) -> error_t
 					  {
+						  item_read = false;
 						  if (max_tries == 0) return lak::err_t{err};
 						  ERROR(err);
 						  DEBUG("Continuing...");
@@ -475,6 +559,8 @@ namespace SourceExplorer
 						  return lak::ok_t{};
 					  }));
 
+					if (item_read && game.on_image_read) game.on_image_read(item);
+
 					game.bank_completed =
 					  float(double(reader.position()) / double(reader.size()));
 				}
@@ -506,6 +592,9 @@ namespace SourceExplorer
 				RES_TRY_TRACE(end->read(game, strm));
 			}
 
+			for (size_t i = 0; i < items.size(); ++i)
+				game.image_handles[items[i].entry.handle] = i;
+
 			return lak::ok_t{};
 		}
 
@@ -28,10 +28,21 @@ namespace SourceExplorer
 			error_t view(source_explorer_t &srcexp) const;
 
 			result_t<data_ref_span_t> image_data() const;
+			// Whether the image data is deflated (rather than LZ4 compressed or
+			// stored) inside the item's body.
+			bool deflated() const;
+			// Reads the deflated image data from the item's body.
+			result_t<data_ref_span_t> read_deflated(
+			  data_reader_t &strm, uint32_t &decompressed_length) const;
 			bool need_palette() const;
 			result_t<lak::image4_t> image(
 			  const bool color_transparent,
 			  const lak::color4_t palette[256] = nullptr) const;
+			// Decodes the image into a caller owned buffer of exactly size.x *
+			// size.y pixels.
+			error_t image_into(lak::span<lak::color4_t> pixels,
+			                   const bool color_transparent,
+			                   const lak::color4_t palette[256] = nullptr) const;
 		};
 
 		struct end_t : public basic_chunk_t
@@ -56,9 +56,11 @@ namespace SourceExplorer
 
 				for (auto &item : items)
 				{
+					bool item_read = true;
 					RES_TRY(read_item(item).or_else(
 					  [&](const auto &err) -> error_t
 					  {
+						  item_read = false;
 						  if (max_tries == 0) return lak::err_t{err};
 						  ERROR(err);
 						  DEBUG("Continuing...");
@@ -66,6 +68,8 @@ namespace SourceExplorer
 						  return lak::ok_t{};
 					  }));
 
+					if (item_read && game.on_music_read) game.on_music_read(item);
+
 					game.bank_completed =
 					  float(double(reader.position()) / double(reader.size()));
 				}
@@ -147,7 +147,9 @@ namespace SourceExplorer
 				  shape.view(srcexp).RES_ADD_TRACE("object::quick_backdrop_t::view"));
 
 				ImGui::Text("Handle: 0x%zX", (size_t)shape.handle);
-				if (shape.handle < 0xFFFF)
+				if (shape.handle < 0xFFFF && !srcexp.state.game.image_bank.ready())
+					ImGui::Text("Image Bank Loading...");
+				else if (shape.handle < 0xFFFF)
 				{
 					RES_TRY(
 					  GetImage(srcexp.state, shape.handle)
@@ -205,7 +207,9 @@ namespace SourceExplorer
 				ImGui::Text(
 				  "Dimension: (%li, %li)", (long)dimension.x, (long)dimension.y);
 				ImGui::Text("Handle: 0x%zX", (size_t)handle);
-				if (handle < 0xFFFF)
+				if (handle < 0xFFFF && !srcexp.state.game.image_bank.ready())
+					ImGui::Text("Image Bank Loading...");
+				else if (handle < 0xFFFF)
 				{
 					RES_TRY(
 					  GetImage(srcexp.state, handle)
@@ -258,6 +262,13 @@ namespace SourceExplorer
 			ImGui::Text("Back To: 0x%zX", (size_t)back_to);
 			ImGui::Text("Frames: 0x%zX", handles.size());
 
+			// Don't wait on the image bank if it's still being read.
+			if (!handles.empty() && !srcexp.state.game.image_bank.ready())
+			{
+				ImGui::Text("Image Bank Loading...");
+				return lak::ok_t{};
+			}
+
 			int index = 0;
 			for (const auto &handle : handles)
 			{
@@ -424,7 +435,7 @@ namespace SourceExplorer
 			//     mode = game_mode_t::_284;
 			// else
 			//     mode = game_mode_t::_OLD;
-			mode = _mode;
+			mode = game.decode_context->mode();
 
 			// used for offsets.
 			const size_t begin = cstrm.position();
@@ -807,6 +818,9 @@ namespace SourceExplorer
 				        " bytes left in the object bank");
 			}
 
+			for (size_t i = 0; i < items.size(); ++i)
+				game.object_handles[items[i].handle] = i;
+
 			return lak::ok_t{};
 		}
 
@@ -0,0 +1,566 @@
+#include "color_kernels.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||          \
+  defined(_M_IX86)
+#	define SE_COLOR_KERNELS_X86
+#	include <immintrin.h>
+#	if defined(_MSC_VER) && !defined(__clang__)
+#		include <intrin.h>
+// MSVC allows intrinsics for any instruction set without opting in.
+#		define SE_TARGET(ISA)
+#	else
+#		define SE_TARGET(ISA) __attribute__((target(ISA)))
+#	endif
+#endif
+
+namespace SourceExplorer
+{
+	namespace
+	{
+		// The reference kernels, these match the per pixel ColorFrom*
+		// functions in explorer.cpp.
+
+		void scalar_from_24bit_bgr(byte_t *rgba, const byte_t *bgr, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				rgba[(i * 4) + 0] = bgr[(i * 3) + 2];
+				rgba[(i * 4) + 1] = bgr[(i * 3) + 1];
+				rgba[(i * 4) + 2] = bgr[(i * 3) + 0];
+				rgba[(i * 4) + 3] = byte_t(255);
+			}
+		}
+
+		void scalar_from_24bit_rgb(byte_t *rgba, const byte_t *rgb, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				rgba[(i * 4) + 0] = rgb[(i * 3) + 0];
+				rgba[(i * 4) + 1] = rgb[(i * 3) + 1];
+				rgba[(i * 4) + 2] = rgb[(i * 3) + 2];
+				rgba[(i * 4) + 3] = byte_t(255);
+			}
+		}
+
+		void scalar_from_32bit_bgra(byte_t *rgba, const byte_t *bgra, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				rgba[(i * 4) + 0] = bgra[(i * 4) + 2];
+				rgba[(i * 4) + 1] = bgra[(i * 4) + 1];
+				rgba[(i * 4) + 2] = bgra[(i * 4) + 0];
+				rgba[(i * 4) + 3] = bgra[(i * 4) + 3];
+			}
+		}
+
+		void scalar_from_32bit_bgr(byte_t *rgba, const byte_t *bgr, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				rgba[(i * 4) + 0] = bgr[(i * 4) + 2];
+				rgba[(i * 4) + 1] = bgr[(i * 4) + 1];
+				rgba[(i * 4) + 2] = bgr[(i * 4) + 0];
+				rgba[(i * 4) + 3] = byte_t(255);
+			}
+		}
+
+		uint16_t load_u16(const byte_t *data)
+		{
+			return uint16_t(uint8_t(data[0]) | (uint8_t(data[1]) << 8));
+		}
+
+		void scalar_from_15bit_rgb(byte_t *rgba, const byte_t *rgb, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const uint16_t value = load_u16(rgb + (i * 2));
+				rgba[(i * 4) + 0]    = byte_t((value & 0x7C00) >> 7);
+				rgba[(i * 4) + 1]    = byte_t((value & 0x03E0) >> 2);
+				rgba[(i * 4) + 2]    = byte_t((value & 0x001F) << 3);
+				rgba[(i * 4) + 3]    = byte_t(255);
+			}
+		}
+
+		void scalar_from_16bit_rgb(byte_t *rgba, const byte_t *rgb, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const uint16_t value = load_u16(rgb + (i * 2));
+				rgba[(i * 4) + 0]    = byte_t((value & 0xF800) >> 8);
+				rgba[(i * 4) + 1]    = byte_t((value & 0x07E0) >> 3);
+				rgba[(i * 4) + 2]    = byte_t((value & 0x001F) << 3);
+				rgba[(i * 4) + 3]    = byte_t(255);
+			}
+		}
+
+		void scalar_from_8bit_i(byte_t *rgba,
+		                        const byte_t *index,
+		                        const byte_t *palette,
+		                        size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+				std::memcpy(rgba + (i * 4), palette + (uint8_t(index[i]) * 4), 4);
+		}
+
+		void scalar_mask_from_8bit_a(byte_t *rgba, const byte_t *a, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i) rgba[(i * 4) + 3] = a[i];
+		}
+
+		constexpr color_kernels_t scalar_kernels = {
+		  "scalar",
+		  &scalar_from_24bit_bgr,
+		  &scalar_from_24bit_rgb,
+		  &scalar_from_32bit_bgra,
+		  &scalar_from_32bit_bgr,
+		  &scalar_from_15bit_rgb,
+		  &scalar_from_16bit_rgb,
+		  &scalar_from_8bit_i,
+		  &scalar_mask_from_8bit_a,
+		};
+
+#ifdef SE_COLOR_KERNELS_X86
+		// Each kernel converts as many pixels as it can with whole vectors,
+		// never reading past the end of the input, then hands the rest to the
+		// scalar kernel.
+
+		// Shuffles that move packed pixels into RGBA order, -1 zeroes the byte
+		// so the alpha can be ORed in. Formats without alpha OR in 0xFF.
+#	define SE_SHUFFLE_24(R, G, B)                                             \
+		R + 0, G + 0, B + 0, -1, R + 3, G + 3, B + 3, -1, R + 6, G + 6, B + 6,   \
+		  -1, R + 9, G + 9, B + 9, -1
+#	define SE_SHUFFLE_32(R, G, B, A)                                          \
+		R + 0, G + 0, B + 0, A + 0, R + 4, G + 4, B + 4, A + 4, R + 8, G + 8,    \
+		  B + 8, A + 8, R + 12, G + 12, B + 12, A + 12
+
+		SE_TARGET("ssse3")
+		size_t ssse3_shuffle_24(byte_t *rgba,
+		                        const byte_t *packed,
+		                        size_t count,
+		                        __m128i shuffle)
+		{
+			const __m128i alpha = _mm_set1_epi32(int(0xFF000000));
+			size_t i            = 0;
+			// 4 pixels come from 12 bytes, but 16 are read.
+			for (; i + 6 <= count; i += 4)
+			{
+				const __m128i in =
+				  _mm_loadu_si128(reinterpret_cast<const __m128i *>(packed + (i * 3)));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(rgba + (i * 4)),
+				                 _mm_or_si128(_mm_shuffle_epi8(in, shuffle), alpha));
+			}
+			return i;
+		}
+
+		SE_TARGET("ssse3")
+		size_t ssse3_shuffle_32(byte_t *rgba,
+		                        const byte_t *packed,
+		                        size_t count,
+		                        __m128i shuffle,
+		                        __m128i alpha)
+		{
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				const __m128i in =
+				  _mm_loadu_si128(reinterpret_cast<const __m128i *>(packed + (i * 4)));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(rgba + (i * 4)),
+				                 _mm_or_si128(_mm_shuffle_epi8(in, shuffle), alpha));
+			}
+			return i;
+		}
+
+		// Interleaves 16 bit R, G and B channels (each already in the low byte
+		// of its lane) into 8 RGBA pixels.
+		SE_TARGET("ssse3")
+		void ssse3_store_565(byte_t *rgba, __m128i r, __m128i g, __m128i b)
+		{
+			const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+			const __m128i ba = _mm_or_si128(b, _mm_set1_epi16(int16_t(0xFF00)));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(rgba),
+			                 _mm_unpacklo_epi16(rg, ba));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(rgba + 16),
+			                 _mm_unpackhi_epi16(rg, ba));
+		}
+
+		SE_TARGET("ssse3")
+		void ssse3_from_24bit_bgr(byte_t *rgba, const byte_t *bgr, size_t count)
+		{
+			const size_t done = ssse3_shuffle_24(
+			  rgba, bgr, count, _mm_setr_epi8(SE_SHUFFLE_24(2, 1, 0)));
+			scalar_from_24bit_bgr(rgba + (done * 4), bgr + (done * 3), count - done);
+		}
+
+		SE_TARGET("ssse3")
+		void ssse3_from_24bit_rgb(byte_t *rgba, const byte_t *rgb, size_t count)
+		{
+			const size_t done = ssse3_shuffle_24(
+			  rgba, rgb, count, _mm_setr_epi8(SE_SHUFFLE_24(0, 1, 2)));
+			scalar_from_24bit_rgb(rgba + (done * 4), rgb + (done * 3), count - done);
+		}
+
+		SE_TARGET("ssse3")
+		void ssse3_from_32bit_bgra(byte_t *rgba, const byte_t *bgra, size_t count)
+		{
+			const size_t done =
+			  ssse3_shuffle_32(rgba,
+			                   bgra,
+			                   count,
+			                   _mm_setr_epi8(SE_SHUFFLE_32(2, 1, 0, 3)),
+			                   _mm_setzero_si128());
+			scalar_from_32bit_bgra(
+			  rgba + (done * 4), bgra + (done * 4), count - done);
+		}
+
+		SE_TARGET("ssse3")
+		void ssse3_from_32bit_bgr(byte_t *rgba, const byte_t *bgr, size_t count)
+		{
+			const size_t done =
+			  ssse3_shuffle_32(rgba,
+			                   bgr,
+			                   count,
+			                   _mm_setr_epi8(SE_SHUFFLE_32(2, 1, 0, 3)),
+			                   _mm_set1_epi32(int(0xFF000000)));
+			scalar_from_32bit_bgr(rgba + (done * 4), bgr + (done * 4), count - done);
+		}
+
+		SE_TARGET("ssse3")
+		void ssse3_from_15bit_rgb(byte_t *rgba, const byte_t *rgb, size_t count)
+		{
+			const __m128i mask = _mm_set1_epi16(0xF8);
+			size_t i           = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m128i in =
+				  _mm_loadu_si128(reinterpret_cast<const __m128i *>(rgb + (i * 2)));
+				ssse3_store_565(rgba + (i * 4),
+				                _mm_and_si128(_mm_srli_epi16(in, 7), mask),
+				                _mm_and_si128(_mm_srli_epi16(in, 2), mask),
+				                _mm_and_si128(_mm_slli_epi16(in, 3), mask));
+			}
+			scalar_from_15bit_rgb(rgba + (i * 4), rgb + (i * 2), count - i);
+		}
+
+		SE_TARGET("ssse3")
+		void ssse3_from_16bit_rgb(byte_t *rgba, const byte_t *rgb, size_t count)
+		{
+			const __m128i mask       = _mm_set1_epi16(0xF8);
+			const __m128i green_mask = _mm_set1_epi16(0xFC);
+			size_t i                 = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m128i in =
+				  _mm_loadu_si128(reinterpret_cast<const __m128i *>(rgb + (i * 2)));
+				ssse3_store_565(rgba + (i * 4),
+				                _mm_and_si128(_mm_srli_epi16(in, 8), mask),
+				                _mm_and_si128(_mm_srli_epi16(in, 3), green_mask),
+				                _mm_and_si128(_mm_slli_epi16(in, 3), mask));
+			}
+			scalar_from_16bit_rgb(rgba + (i * 4), rgb + (i * 2), count - i);
+		}
+
+		SE_TARGET("ssse3")
+		void ssse3_mask_from_8bit_a(byte_t *rgba, const byte_t *a, size_t count)
+		{
+			const __m128i color_mask = _mm_set1_epi32(0x00FFFFFF);
+			const __m128i shuffle    = _mm_setr_epi8(
+        -1, -1, -1, 0, -1, -1, -1, 1, -1, -1, -1, 2, -1, -1, -1, 3);
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				int32_t alpha;
+				std::memcpy(&alpha, a + i, 4);
+				__m128i *out = reinterpret_cast<__m128i *>(rgba + (i * 4));
+				_mm_storeu_si128(
+				  out,
+				  _mm_or_si128(
+				    _mm_and_si128(_mm_loadu_si128(out), color_mask),
+				    _mm_shuffle_epi8(_mm_cvtsi32_si128(alpha), shuffle)));
+			}
+			scalar_mask_from_8bit_a(rgba + (i * 4), a + i, count - i);
+		}
+
+		// SSSE3 has no gather, the palette lookup is already just a load and
+		// store per pixel.
+		constexpr color_kernels_t ssse3_kernels = {
+		  "ssse3",
+		  &ssse3_from_24bit_bgr,
+		  &ssse3_from_24bit_rgb,
+		  &ssse3_from_32bit_bgra,
+		  &ssse3_from_32bit_bgr,
+		  &ssse3_from_15bit_rgb,
+		  &ssse3_from_16bit_rgb,
+		  &scalar_from_8bit_i,
+		  &ssse3_mask_from_8bit_a,
+		};
+
+		// AVX2 shuffles only within 128 bit lanes, so the same 16 byte
+		// shuffles are used on each half of the vector.
+
+		SE_TARGET("avx2")
+		size_t avx2_shuffle_24(byte_t *rgba,
+		                       const byte_t *packed,
+		                       size_t count,
+		                       __m128i shuffle)
+		{
+			const __m256i shuffle2 = _mm256_broadcastsi128_si256(shuffle);
+			const __m256i alpha    = _mm256_set1_epi32(int(0xFF000000));
+			size_t i               = 0;
+			// 8 pixels come from 24 bytes, the second half is read from 12
+			// bytes in, so 28 bytes are read.
+			for (; i + 10 <= count; i += 8)
+			{
+				const byte_t *in = packed + (i * 3);
+				const __m256i pixels = _mm256_inserti128_si256(
+				  _mm256_castsi128_si256(
+				    _mm_loadu_si128(reinterpret_cast<const __m128i *>(in))),
+				  _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 12)),
+				  1);
+				_mm256_storeu_si256(
+				  reinterpret_cast<__m256i *>(rgba + (i * 4)),
+				  _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle2), alpha));
+			}
+			return i;
+		}
+
+		SE_TARGET("avx2")
+		size_t avx2_shuffle_32(byte_t *rgba,
+		                       const byte_t *packed,
+		                       size_t count,
+		                       __m128i shuffle,
+		                       __m128i alpha)
+		{
+			const __m256i shuffle2 = _mm256_broadcastsi128_si256(shuffle);
+			const __m256i alpha2   = _mm256_broadcastsi128_si256(alpha);
+			size_t i               = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256i pixels = _mm256_loadu_si256(
+				  reinterpret_cast<const __m256i *>(packed + (i * 4)));
+				_mm256_storeu_si256(
+				  reinterpret_cast<__m256i *>(rgba + (i * 4)),
+				  _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle2), alpha2));
+			}
+			return i;
+		}
+
+		// Interleaves 16 bit R, G and B channels into 16 RGBA pixels.
+		SE_TARGET("avx2")
+		void avx2_store_565(byte_t *rgba, __m256i r, __m256i g, __m256i b)
+		{
+			const __m256i rg = _mm256_or_si256(r, _mm256_slli_epi16(g, 8));
+			const __m256i ba =
+			  _mm256_or_si256(b, _mm256_set1_epi16(int16_t(0xFF00)));
+			// Unpacking works within lanes, so the low half holds pixels 0-3 and
+			// 8-11, and the high half 4-7 and 12-15.
+			const __m256i low  = _mm256_unpacklo_epi16(rg, ba);
+			const __m256i high = _mm256_unpackhi_epi16(rg, ba);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(rgba),
+			                    _mm256_permute2x128_si256(low, high, 0x20));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(rgba + 32),
+			                    _mm256_permute2x128_si256(low, high, 0x31));
+		}
+
+		SE_TARGET("avx2")
+		void avx2_from_24bit_bgr(byte_t *rgba, const byte_t *bgr, size_t count)
+		{
+			const size_t done = avx2_shuffle_24(
+			  rgba, bgr, count, _mm_setr_epi8(SE_SHUFFLE_24(2, 1, 0)));
+			ssse3_from_24bit_bgr(rgba + (done * 4), bgr + (done * 3), count - done);
+		}
+
+		SE_TARGET("avx2")
+		void avx2_from_24bit_rgb(byte_t *rgba, const byte_t *rgb, size_t count)
+		{
+			const size_t done = avx2_shuffle_24(
+			  rgba, rgb, count, _mm_setr_epi8(SE_SHUFFLE_24(0, 1, 2)));
+			ssse3_from_24bit_rgb(rgba + (done * 4), rgb + (done * 3), count - done);
+		}
+
+		SE_TARGET("avx2")
+		void avx2_from_32bit_bgra(byte_t *rgba, const byte_t *bgra, size_t count)
+		{
+			const size_t done =
+			  avx2_shuffle_32(rgba,
+			                  bgra,
+			                  count,
+			                  _mm_setr_epi8(SE_SHUFFLE_32(2, 1, 0, 3)),
+			                  _mm_setzero_si128());
+			scalar_from_32bit_bgra(
+			  rgba + (done * 4), bgra + (done * 4), count - done);
+		}
+
+		SE_TARGET("avx2")
+		void avx2_from_32bit_bgr(byte_t *rgba, const byte_t *bgr, size_t count)
+		{
+			const size_t done =
+			  avx2_shuffle_32(rgba,
+			                  bgr,
+			                  count,
+			                  _mm_setr_epi8(SE_SHUFFLE_32(2, 1, 0, 3)),
+			                  _mm_set1_epi32(int(0xFF000000)));
+			scalar_from_32bit_bgr(rgba + (done * 4), bgr + (done * 4), count - done);
+		}
+
+		SE_TARGET("avx2")
+		void avx2_from_15bit_rgb(byte_t *rgba, const byte_t *rgb, size_t count)
+		{
+			const __m256i mask = _mm256_set1_epi16(0xF8);
+			size_t i           = 0;
+			for (; i + 16 <= count; i += 16)
+			{
+				const __m256i in =
+				  _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rgb + (i * 2)));
+				avx2_store_565(rgba + (i * 4),
+				               _mm256_and_si256(_mm256_srli_epi16(in, 7), mask),
+				               _mm256_and_si256(_mm256_srli_epi16(in, 2), mask),
+				               _mm256_and_si256(_mm256_slli_epi16(in, 3), mask));
+			}
+			ssse3_from_15bit_rgb(rgba + (i * 4), rgb + (i * 2), count - i);
+		}
+
+		SE_TARGET("avx2")
+		void avx2_from_16bit_rgb(byte_t *rgba, const byte_t *rgb, size_t count)
+		{
+			const __m256i mask       = _mm256_set1_epi16(0xF8);
+			const __m256i green_mask = _mm256_set1_epi16(0xFC);
+			size_t i                 = 0;
+			for (; i + 16 <= count; i += 16)
+			{
+				const __m256i in =
+				  _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rgb + (i * 2)));
+				avx2_store_565(rgba + (i * 4),
+				               _mm256_and_si256(_mm256_srli_epi16(in, 8), mask),
+				               _mm256_and_si256(_mm256_srli_epi16(in, 3), green_mask),
+				               _mm256_and_si256(_mm256_slli_epi16(in, 3), mask));
+			}
+			ssse3_from_16bit_rgb(rgba + (i * 4), rgb + (i * 2), count - i);
+		}
+
+		SE_TARGET("avx2")
+		void avx2_from_8bit_i(byte_t *rgba,
+		                      const byte_t *index,
+		                      const byte_t *palette,
+		                      size_t count)
+		{
+			const int *colors = reinterpret_cast<const int *>(palette);
+			size_t i          = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256i indices = _mm256_cvtepu8_epi32(
+				  _mm_loadl_epi64(reinterpret_cast<const __m128i *>(index + i)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(rgba + (i * 4)),
+				                    _mm256_i32gather_epi32(colors, indices, 4));
+			}
+			scalar_from_8bit_i(rgba + (i * 4), index + i, palette, count - i);
+		}
+
+		SE_TARGET("avx2")
+		void avx2_mask_from_8bit_a(byte_t *rgba, const byte_t *a, size_t count)
+		{
+			const __m256i color_mask = _mm256_set1_epi32(0x00FFFFFF);
+			size_t i                 = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256i alpha = _mm256_slli_epi32(
+				  _mm256_cvtepu8_epi32(
+				    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(a + i))),
+				  24);
+				__m256i *out = reinterpret_cast<__m256i *>(rgba + (i * 4));
+				_mm256_storeu_si256(
+				  out,
+				  _mm256_or_si256(
+				    _mm256_and_si256(_mm256_loadu_si256(out), color_mask), alpha));
+			}
+			scalar_mask_from_8bit_a(rgba + (i * 4), a + i, count - i);
+		}
+
+#	undef SE_SHUFFLE_24
+#	undef SE_SHUFFLE_32
+
+		constexpr color_kernels_t avx2_kernels = {
+		  "avx2",
+		  &avx2_from_24bit_bgr,
+		  &avx2_from_24bit_rgb,
+		  &avx2_from_32bit_bgra,
+		  &avx2_from_32bit_bgr,
+		  &avx2_from_15bit_rgb,
+		  &avx2_from_16bit_rgb,
+		  &avx2_from_8bit_i,
+		  &avx2_mask_from_8bit_a,
+		};
+
+		struct cpu_features_t
+		{
+			bool ssse3 = false;
+			bool avx2  = false;
+		};
+
+		cpu_features_t cpu_features()
+		{
+			cpu_features_t result;
+#	if defined(_MSC_VER) && !defined(__clang__)
+			int info[4];
+			__cpuid(info, 0);
+			const int max_leaf = info[0];
+
+			__cpuid(info, 1);
+			result.ssse3 = (info[2] & (1 << 9)) != 0;
+			// AVX state must also be enabled by the OS.
+			const bool os_avx = (info[2] & (1 << 27)) != 0 &&
+			                    (info[2] & (1 << 28)) != 0 &&
+			                    (_xgetbv(0) & 0x6) == 0x6;
+
+			if (max_leaf >= 7)
+			{
+				__cpuidex(info, 7, 0);
+				result.avx2 = os_avx && (info[1] & (1 << 5)) != 0;
+			}
+#	else
+			__builtin_cpu_init();
+			result.ssse3 = __builtin_cpu_supports("ssse3");
+			result.avx2  = __builtin_cpu_supports("avx2");
+#	endif
+			return result;
+		}
+#endif
+
+		struct supported_kernels_t
+		{
+			const color_kernels_t *kernels[3] = {&scalar_kernels};
+			size_t count                      = 1;
+
+			supported_kernels_t()
+			{
+#ifdef SE_COLOR_KERNELS_X86
+				const cpu_features_t features = cpu_features();
+				if (features.ssse3) kernels[count++] = &ssse3_kernels;
+				if (features.ssse3 && features.avx2) kernels[count++] = &avx2_kernels;
+#endif
+			}
+		};
+
+		const supported_kernels_t &supported_kernels()
+		{
+			static const supported_kernels_t supported;
+			return supported;
+		}
+	}
+
+	const color_kernels_t &scalar_color_kernels() { return scalar_kernels; }
+
+	const color_kernels_t &color_kernels()
+	{
+		const auto &supported = supported_kernels();
+		return *supported.kernels[supported.count - 1];
+	}
+
+	lak::span<const color_kernels_t *const> supported_color_kernels()
+	{
+		const auto &supported = supported_kernels();
+		return lak::span<const color_kernels_t *const>(supported.kernels,
+		                                               supported.count);
+	}
+}
@@ -0,0 +1,47 @@
+#ifndef SRCEXP_CTF_COLOR_KERNELS_HPP
+#define SRCEXP_CTF_COLOR_KERNELS_HPP
+
+#include <lak/span.hpp>
+#include <lak/stdint.hpp>
+
+#include <stdint.h>
+
+namespace SourceExplorer
+{
+	// Converts count packed pixels into RGBA colors, 4 bytes per pixel.
+	using color_kernel_t = void (*)(byte_t *rgba,
+	                                const byte_t *packed,
+	                                size_t count);
+
+	// Looks count 8 bit indices up in a palette of 256 RGBA colors.
+	using palette_kernel_t = void (*)(byte_t *rgba,
+	                                  const byte_t *index,
+	                                  const byte_t *palette,
+	                                  size_t count);
+
+	struct color_kernels_t
+	{
+		const char *name;
+		color_kernel_t from_24bit_bgr;
+		color_kernel_t from_24bit_rgb;
+		color_kernel_t from_32bit_bgra;
+		color_kernel_t from_32bit_bgr;
+		color_kernel_t from_15bit_rgb;
+		color_kernel_t from_16bit_rgb;
+		palette_kernel_t from_8bit_i;
+		// Replaces only the alpha channel of rgba.
+		color_kernel_t mask_from_8bit_a;
+	};
+
+	// The plain per pixel kernels, which the others must match exactly.
+	const color_kernels_t &scalar_color_kernels();
+
+	// The fastest kernels this CPU supports, picked the first time this is
+	// called.
+	const color_kernels_t &color_kernels();
+
+	// Every set of kernels this CPU supports, starting with the scalar ones.
+	lak::span<const color_kernels_t *const> supported_color_kernels();
+}
+
+#endif
@@ -4,9 +4,197 @@
 
 namespace SourceExplorer
 {
-	result_t<data_ref_span_t> data_point_t::decode(const chunk_t ID,
-	                                               const encoding_t mode) const
+	bool decode_context_t::decode_chunk(lak::span<byte_t> chunk)
 	{
-		return Decode(data, ID, mode);
+		return decode_chunk(chunk, chunk);
+	}
+
+	bool decode_context_t::decode_chunk(lak::span<const byte_t> src,
+	                                    lak::span<byte_t> dst)
+	{
+		{
+			std::shared_lock lock(_key_mutex);
+			if (_decryptor.valid) return _decryptor.decode(src, dst);
+		}
+
+		// Only the first decode after the key changes gets here.
+		std::unique_lock lock(_key_mutex);
+		if (!_decryptor.valid)
+		{
+			if (_magic_key.size() < 0x100) return false;
+			if (!_decryptor.init(lak::span(_magic_key).first<0x100>(), _magic_char))
+				return false;
+		}
+		return _decryptor.decode(src, dst);
+	}
+
+	game_mode_t decode_context_t::mode() const
+	{
+		std::shared_lock lock(_key_mutex);
+		return _mode;
+	}
+
+	void decode_context_t::set_mode(game_mode_t mode)
+	{
+		std::unique_lock lock(_key_mutex);
+		_mode = mode;
+	}
+
+	uint8_t decode_context_t::magic_char() const
+	{
+		std::shared_lock lock(_key_mutex);
+		return _magic_char;
+	}
+
+	void decode_context_t::set_magic_char(uint8_t magic_char)
+	{
+		std::unique_lock lock(_key_mutex);
+		_magic_char      = magic_char;
+		_decryptor.valid = false;
+	}
+
+	lak::array<uint8_t> decode_context_t::magic_key() const
+	{
+		std::shared_lock lock(_key_mutex);
+		return _magic_key;
+	}
+
+	bool decode_context_t::has_magic_key() const
+	{
+		std::shared_lock lock(_key_mutex);
+		return _magic_key.size() >= 0x100;
+	}
+
+	void decode_context_t::set_magic_key(lak::array<uint8_t> key)
+	{
+		std::unique_lock lock(_key_mutex);
+		_magic_key       = lak::move(key);
+		_decryptor.valid = false;
+		cache.clear();
+	}
+
+	decode_context_t::compression_t decode_context_t::chunk_compression(
+	  chunk_t ID, bool head)
+	{
+		std::lock_guard lock(_compression_mutex);
+		auto it = _compression.find((uint32_t(ID) << 1) | uint32_t(head));
+		return it == _compression.end() ? compression_t::unknown : it->second;
+	}
+
+	void decode_context_t::set_chunk_compression(chunk_t ID,
+	                                             bool head,
+	                                             bool compressed)
+	{
+		std::lock_guard lock(_compression_mutex);
+		_compression[(uint32_t(ID) << 1) | uint32_t(head)] =
+		  compressed ? compression_t::compressed : compression_t::uncompressed;
+	}
+
+	lak::optional<data_ref_span_t> decode_cache_t::find(const key_t &key)
+	{
+		std::lock_guard lock(_mutex);
+
+		auto it = _map.find(key);
+		if (it == _map.end())
+		{
+			++_stats.misses;
+			return lak::nullopt;
+		}
+
+		++_stats.hits;
+		_lru.splice(_lru.begin(), _lru, it->second);
+		return lak::optional<data_ref_span_t>(it->second->decoded);
+	}
+
+	void decode_cache_t::insert(const data_ref_span_t &encoded,
+	                            const key_t &key,
+	                            const data_ref_span_t &decoded,
+	                            size_t generation)
+	{
+		// Decoding didn't produce any new data (e.g. mode0 chunks), there's
+		// nothing to save by caching it.
+		if (decoded._source == encoded._source) return;
+
+		const size_t budget = decode_cache_budget;
+		if (decoded.size() > budget) return;
+
+		std::lock_guard lock(_mutex);
+
+		if (generation != _generation) return;
+		if (_map.find(key) != _map.end()) return;
+
+		while (!_lru.empty() && _stats.bytes + decoded.size() > budget)
+		{
+			_stats.bytes -= _lru.back().decoded.size();
+			_map.erase(_lru.back().key);
+			_lru.pop_back();
+			++_stats.evictions;
+		}
+
+		_lru.push_front(node_t{key, encoded, decoded});
+		_map.emplace(key, _lru.begin());
+		_stats.bytes += decoded.size();
+		_stats.entries = _lru.size();
+	}
+
+	void decode_cache_t::clear()
+	{
+		std::lock_guard lock(_mutex);
+		++_generation;
+		_map.clear();
+		_lru.clear();
+		_stats.bytes   = 0;
+		_stats.entries = 0;
+	}
+
+	void decode_cache_t::invalidate(const byte_t *begin, const byte_t *end)
+	{
+		// The entries point into all sorts of allocations, so compare addresses
+		// rather than pointers.
+		const auto first = reinterpret_cast<uintptr_t>(begin);
+		const auto last  = reinterpret_cast<uintptr_t>(end);
+
+		std::lock_guard lock(_mutex);
+		++_generation;
+		for (auto it = _lru.begin(); it != _lru.end();)
+		{
+			const auto data = reinterpret_cast<uintptr_t>(it->key.data);
+			if (data < last && first < data + it->key.size)
+			{
+				_stats.bytes -= it->decoded.size();
+				_map.erase(it->key);
+				it = _lru.erase(it);
+			}
+			else
+				++it;
+		}
+		_stats.entries = _lru.size();
+	}
+
+	decode_cache_t::stats_t decode_cache_t::stats() const
+	{
+		std::lock_guard lock(_mutex);
+		auto result    = _stats;
+		result.entries = _lru.size();
+		return result;
+	}
+
+	size_t decode_cache_t::key_hash_t::operator()(const key_t &key) const
+	{
+		size_t result = std::hash<const byte_t *>{}(key.data);
+		auto combine  = [&](size_t value)
+		{ result ^= value + 0x9E3779B9U + (result << 6) + (result >> 2); };
+		combine(key.size);
+		combine(size_t(key.ID));
+		combine(size_t(key.mode));
+		combine(size_t(key.old) | (size_t(key.head) << 1));
+		combine(key.max_size);
+		return result;
+	}
+
+	result_t<data_ref_span_t> data_point_t::decode(
+	  const chunk_t ID, const encoding_t mode, decode_context_t *context) const
+	{
+		return Decode(data, ID, mode, context);
 	}
 }
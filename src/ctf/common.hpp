@@ -16,6 +16,12 @@
 
 #include <misc/softraster/texture.h>
 
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
 #ifdef GetObject
 #	undef GetObject
 #endif
@@ -160,8 +166,17 @@ namespace SourceExplorer
 	extern bool force_compat;
 	extern bool skip_broken_items;
 	extern bool open_broken_games;
-	extern lak::array<uint8_t> _magic_key;
-	extern uint8_t _magic_char;
+	extern bool memory_map_files;
+	extern size_t mapped_window_size;
+	// Max bytes of a memory mapped file to keep resident, 0 for unlimited.
+	extern size_t mapped_file_budget;
+	// Max bytes of decoded data to keep in each game's decode cache, 0 to
+	// disable the cache.
+	extern size_t decode_cache_budget;
+	// Streams of at least this many compressed bytes are inflated on multiple
+	// threads, 0 to always inflate serially. Only used by the fast inflate
+	// engine (SE_FAST_INFLATE).
+	extern size_t parallel_inflate_threshold;
 
 	template<typename T>
 	struct chunk_ptr
@@ -202,7 +217,137 @@ namespace SourceExplorer
 		_288,
 		_290 // might be 292?
 	};
-	extern game_mode_t _mode;
+
+	// Least recently used cache of decoded chunk/item data, limited to
+	// decode_cache_budget bytes of decoded data.
+	struct decode_cache_t
+	{
+		struct key_t
+		{
+			// The encoded data. Entries keep the encoded data alive, so its
+			// address can't be reused while it is in the cache.
+			const byte_t *data;
+			size_t size;
+			chunk_t ID;
+			encoding_t mode;
+			bool old;
+			bool head;
+			size_t max_size;
+
+			bool operator==(const key_t &) const = default;
+		};
+
+		struct stats_t
+		{
+			size_t hits      = 0;
+			size_t misses    = 0;
+			size_t evictions = 0;
+			size_t entries   = 0;
+			size_t bytes     = 0;
+		};
+
+		template<typename DECODE>
+		result_t<data_ref_span_t> get_or_decode(const data_ref_span_t &encoded,
+		                                        const key_t &key,
+		                                        DECODE &&decode)
+		{
+			if (auto cached = find(key); cached) return lak::ok_t{*cached};
+			const size_t before = generation();
+			auto result         = decode();
+			if (result.is_ok())
+				insert(encoded, key, result.unsafe_unwrap(), before);
+			return result;
+		}
+
+		lak::optional<data_ref_span_t> find(const key_t &key);
+		// generation is what generation() returned before decoded was decoded,
+		// if the cache has been cleared or invalidated since then decoded may
+		// be stale and isn't inserted.
+		void insert(const data_ref_span_t &encoded,
+		            const key_t &key,
+		            const data_ref_span_t &decoded,
+		            size_t generation);
+		void clear();
+		// Drops every entry whose encoded data overlaps [begin, end), for when
+		// those bytes have been edited.
+		void invalidate(const byte_t *begin, const byte_t *end);
+		size_t generation() const { return _generation; }
+		stats_t stats() const;
+
+	private:
+		struct key_hash_t
+		{
+			size_t operator()(const key_t &key) const;
+		};
+
+		struct node_t
+		{
+			key_t key;
+			data_ref_span_t encoded;
+			data_ref_span_t decoded;
+		};
+
+		mutable std::mutex _mutex;
+		// Most recently used first.
+		std::list<node_t> _lru;
+		std::unordered_map<key_t, std::list<node_t>::iterator, key_hash_t> _map;
+		stats_t _stats;
+		// Bumped (under _mutex) whenever entries are cleared or invalidated.
+		std::atomic_size_t _generation = 0;
+	};
+
+	// Per game state needed to decode mode2/mode3 chunks. The key fields are
+	// read while other threads are decoding chunks, so they are only reached
+	// through these (locked) accessors.
+	struct decode_context_t
+	{
+		game_mode_t mode() const;
+		void set_mode(game_mode_t mode);
+
+		uint8_t magic_char() const;
+		// Resets the decryption table, the key has to be regenerated with the
+		// new char (see GetEncryptionKey).
+		void set_magic_char(uint8_t magic_char);
+
+		// A copy of the key, empty if it hasn't been generated yet.
+		lak::array<uint8_t> magic_key() const;
+		bool has_magic_key() const;
+		// Clears the cache, as anything decrypted with the old key is invalid.
+		void set_magic_key(lak::array<uint8_t> key);
+
+		// Decrypts chunk in place, creating the decryption table from the magic
+		// key if it hasn't been already.
+		bool decode_chunk(lak::span<byte_t> chunk);
+		// Decrypts src into dst, which must be at least as big as src.
+		bool decode_chunk(lak::span<const byte_t> src, lak::span<byte_t> dst);
+
+		decode_cache_t cache;
+
+		// Whether chunks of a given type (head or body) turned out to be zlib
+		// compressed, so that chunks of a compressed type go straight to the
+		// inflater. Uncompressed types are still checked every time.
+		enum struct compression_t : uint8_t
+		{
+			unknown,
+			compressed,
+			uncompressed,
+		};
+
+		compression_t chunk_compression(chunk_t ID, bool head);
+		void set_chunk_compression(chunk_t ID, bool head, bool compressed);
+
+	private:
+		// Held shared for the whole of every decode, so the table can't be reset
+		// out from under it.
+		mutable std::shared_mutex _key_mutex;
+		game_mode_t _mode   = game_mode_t::_OLD;
+		uint8_t _magic_char = 0;
+		lak::array<uint8_t> _magic_key;
+		encryption_table _decryptor;
+
+		std::mutex _compression_mutex;
+		std::unordered_map<uint32_t, compression_t> _compression;
+	};
 
 	struct game_t;
 	struct source_explorer_t;
@@ -228,7 +373,8 @@ namespace SourceExplorer
 			  data.position().map_err([](auto &&) -> size_t { return SIZE_MAX; }));
 		}
 		result_t<data_ref_span_t> decode(const chunk_t ID,
-		                                 const encoding_t mode) const;
+		                                 const encoding_t mode,
+		                                 decode_context_t *context) const;
 	};
 
 	struct game_t;
@@ -2,6 +2,7 @@
 
 #include <lak/utility.hpp>
 
+#include <algorithm>
 #include <numeric>
 
 bool encryption_table::init(lak::span<const uint8_t, 0x100U> magic_key,
@@ -50,31 +51,95 @@ bool encryption_table::init(lak::span<const uint8_t, 0x100U> magic_key,
 		lak::swap(decode_buffer.u32[i], decode_buffer.u32[i2]);
 	}
 
+	{
+		std::lock_guard lock(_keystream_mutex);
+		_keystream.reset();
+		lak::memcpy(&_stream_buffer, &decode_buffer);
+		_stream_i  = 0U;
+		_stream_i2 = 0U;
+	}
+
 	valid = true;
 	return true;
 #endif
 }
 
+encryption_table::keystream_t encryption_table::keystream(size_t size) const
+{
+	std::lock_guard lock(_keystream_mutex);
+
+	const size_t old_size = _keystream ? _keystream->size() : 0U;
+
+	if (old_size >= size) return _keystream;
+
+	// Grow geometrically so a run of slightly larger chunks doesn't
+	// regenerate the stream every time.
+	const size_t new_size = std::max({size, old_size * 2U, size_t(0x1000U)});
+
+	auto stream = keystream_t::make();
+	stream->resize(new_size);
+	if (old_size > 0U)
+		lak::copy(_keystream->begin(),
+		          _keystream->end(),
+		          stream->begin(),
+		          stream->begin() + old_size);
+
+	uint8_t i  = _stream_i;
+	uint8_t i2 = _stream_i2;
+	auto &buf  = _stream_buffer;
+	for (uint8_t &elem : lak::span(*stream).subspan(old_size))
+	{
+		++i;
+		i2 += (uint8_t)buf.u32[i];
+		lak::swap(buf.u32[i], buf.u32[i2]);
+		elem = buf.u8[4U * uint8_t(buf.u32[i] + buf.u32[i2])];
+	}
+	_stream_i  = i;
+	_stream_i2 = i2;
+
+	_keystream = stream;
+	return stream;
+}
+
 bool encryption_table::decode(lak::span<byte_t> chunk) const
+{
+	return decode(chunk, chunk);
+}
+
+bool encryption_table::decode(lak::span<const byte_t> src,
+                              lak::span<byte_t> dst) const
 {
 #ifndef SE_HAS_INTRIN
-	LAK_UNUSED(chunk);
+	LAK_UNUSED(src);
+	LAK_UNUSED(dst);
 	ASSERT_NYI();
 #else
 	if (!valid) return false;
 
-	decode_buffer_t buffer;
-	lak::memcpy(&buffer, &decode_buffer);
+	ASSERT_GREATER_OR_EQUAL(dst.size(), src.size());
 
-	uint8_t i  = 0U;
-	uint8_t i2 = 0U;
-	for (uint8_t &elem : lak::span<uint8_t>(chunk))
+	if (src.empty()) return true;
+
+	const auto stream = keystream(src.size());
+
+	const uint8_t *in     = reinterpret_cast<const uint8_t *>(src.data());
+	uint8_t *out          = reinterpret_cast<uint8_t *>(dst.data());
+	const uint8_t *key    = stream->data();
+	const size_t size     = src.size();
+	constexpr size_t step = sizeof(__m128i);
+
+	size_t i = 0U;
+	for (; i + step <= size; i += step)
 	{
-		++i;
-		i2 += (uint8_t)buffer.u32[i];
-		lak::swap(buffer.u32[i], buffer.u32[i2]);
-		elem ^= buffer.u8[4U * uint8_t(buffer.u32[i] + buffer.u32[i2])];
+		const __m128i d =
+		  _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+		const __m128i k =
+		  _mm_loadu_si128(reinterpret_cast<const __m128i *>(key + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+		                 _mm_xor_si128(d, k));
 	}
+	for (; i < size; ++i) out[i] = in[i] ^ key[i];
+
 	return true;
 #endif
 }
@@ -10,6 +10,7 @@
 #endif
 
 #include <lak/array.hpp>
+#include <lak/memory.hpp>
 #include <lak/span.hpp>
 
 #include <assert.h>
@@ -18,6 +19,7 @@
 #	include <emmintrin.h>
 #endif
 #include <iostream>
+#include <mutex>
 #include <stdint.h>
 
 #ifdef SE_HAS_INTRIN
@@ -60,7 +62,26 @@ struct encryption_table
 
 	bool init(lak::span<const uint8_t, 0x100> magic_key, const char magic_char);
 
+	// The keystream only depends on the key, so it is generated once and
+	// shared by every chunk, growing to fit the largest chunk decoded so far.
 	bool decode(lak::span<byte_t> chunk) const;
+	// Decrypts src into dst, which must be at least as big as src. src and
+	// dst may be the same span.
+	bool decode(lak::span<const byte_t> src, lak::span<byte_t> dst) const;
+
+private:
+	using keystream_t = lak::shared_ptr<lak::array<uint8_t>>;
+
+	mutable std::mutex _keystream_mutex;
+	// Published keystreams are never modified, a longer stream replaces it.
+	mutable keystream_t _keystream;
+	// The state of the generator at the end of _keystream.
+	mutable decode_buffer_t _stream_buffer;
+	mutable uint8_t _stream_i  = 0U;
+	mutable uint8_t _stream_i2 = 0U;
+
+	// Get a keystream that is at least size bytes long.
+	keystream_t keystream(size_t size) const;
 };
 
 lak::array<uint8_t> KeyString(const lak::u16string &str);
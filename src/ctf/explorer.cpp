@@ -28,7 +28,14 @@
 #include "lak/string_view.hpp"
 
 #include "../tostring.hpp"
+#include "color_kernels.hpp"
 #include "explorer.hpp"
+#include "fast_inflate.hpp"
+#include "fast_lz4.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 
 #ifdef GetObject
 #	undef GetObject
@@ -39,14 +46,18 @@
 
 namespace SourceExplorer
 {
-	bool force_compat          = false;
-	bool skip_broken_items     = false;
-	bool open_broken_games     = true;
-	size_t max_item_read_fails = 3;
-	encryption_table decryptor;
-	lak::array<uint8_t> _magic_key;
-	game_mode_t _mode = game_mode_t::_OLD;
-	uint8_t _magic_char;
+	bool force_compat                 = false;
+	bool skip_broken_items            = false;
+	bool open_broken_games            = true;
+	size_t max_item_read_fails        = 3;
+	bool memory_map_files             = true;
+	size_t mapped_window_size         = 0x1000000;
+	size_t mapped_file_budget         = 0;
+	size_t decode_cache_budget        = 0x4000000;
+	size_t parallel_inflate_threshold = 0;
+	bool lazy_load_banks              = true;
+	bool parallel_load_banks          = false;
+	bool stream_dumps                 = false;
 	std::atomic<float> game_t::completed      = 0.0f;
 	std::atomic<float> game_t::bank_completed = 0.0f;
 	std::atomic<float> game_t::item_completed = 0.0f;
@@ -62,6 +73,23 @@ namespace SourceExplorer
 		return lhs;
 	}
 
+	result_t<data_ref_ptr_t> LoadFile(const fs::path &path)
+	{
+		if (memory_map_files)
+		{
+			if (auto mapping = mapped_file_t::open(
+			      path, mapped_window_size, mapped_file_budget);
+			    mapping.is_ok())
+				return lak::ok_t{make_data_ref_ptr(lak::move(mapping).unwrap())};
+			WARNING("Failed to memory map ", path, ", reading whole file instead");
+		}
+
+		RES_TRY_ASSIGN(auto bytes =,
+		               lak::read_file(path).RES_MAP_TO_TRACE("LoadFile"));
+
+		return lak::ok_t{make_data_ref_ptr(lak::move(bytes))};
+	}
+
 	error_t LoadGame(source_explorer_t &srcexp)
 	{
 		FUNCTION_CHECKPOINT();
@@ -75,11 +103,13 @@ namespace SourceExplorer
 		srcexp.state        = game_t{};
 		srcexp.state.compat = force_compat;
 
-		RES_TRY_ASSIGN(
-		  auto bytes =,
-		  lak::read_file(srcexp.exe.path).RES_MAP_TO_TRACE("LoadGame"));
+		RES_TRY_ASSIGN(srcexp.state.file =,
+		               LoadFile(srcexp.exe.path).RES_ADD_TRACE("LoadGame"));
 
-		srcexp.state.file = make_data_ref_ptr(lak::move(bytes));
+		// The header parse walks the file front to back, after that the banks
+		// are accessed in whatever order the user clicks on them.
+		if (const auto &mapping = srcexp.state.file->mapping(); mapping)
+			mapping->advise(access_pattern_t::sequential);
 
 		data_reader_t strm(srcexp.state.file);
 
@@ -128,20 +158,20 @@ namespace SourceExplorer
 
 		DEBUG("Successfully Parsed Game Header");
 
-		_magic_key.clear();
+		auto &context = *srcexp.state.decode_context;
 
 		if (srcexp.state.product_build < 284 || srcexp.state.old_game ||
 		    srcexp.state.compat)
-			_mode = game_mode_t::_OLD;
+			context.set_mode(game_mode_t::_OLD);
 		else if (srcexp.state.product_build > 285)
-			_mode = game_mode_t::_288;
+			context.set_mode(game_mode_t::_288);
 		else
-			_mode = game_mode_t::_284;
+			context.set_mode(game_mode_t::_284);
 
-		if (_mode == game_mode_t::_OLD)
-			_magic_char = 99; // '6';
+		if (context.mode() == game_mode_t::_OLD)
+			context.set_magic_char(99); // '6';
 		else
-			_magic_char = 54; // 'c';
+			context.set_magic_char(54); // 'c';
 
 		RES_TRY(srcexp.state.game.read(srcexp.state, strm)
 		          .RES_ADD_TRACE("LoadGame: while parsing PE header at: ",
@@ -149,6 +179,9 @@ namespace SourceExplorer
 
 		DEBUG("Successfully Read Game Entry");
 
+		if (const auto &mapping = srcexp.state.file->mapping(); mapping)
+			mapping->advise(access_pattern_t::random);
+
 		DEBUG("Unicode: ", (srcexp.state.unicode ? "true" : "false"));
 
 		if (srcexp.state.game.project_path)
@@ -167,57 +200,41 @@ namespace SourceExplorer
 		if (srcexp.state.recompiled)
 			WARNING("This Game May Have Been Recompiled!");
 
-		if (srcexp.state.game.image_bank)
-		{
-			const auto &images = srcexp.state.game.image_bank->items;
-			for (size_t i = 0; i < images.size(); ++i)
-			{
-				srcexp.state.image_handles[images[i].entry.handle] = i;
-			}
-		}
-
-		if (srcexp.state.game.object_bank)
-		{
-			const auto &objects = srcexp.state.game.object_bank->items;
-			for (size_t i = 0; i < objects.size(); ++i)
-			{
-				srcexp.state.object_handles[objects[i].handle] = i;
-			}
-		}
-
 		return lak::ok_t{};
 	}
 
 	void GetEncryptionKey(game_t &game_state)
 	{
-		_magic_key.clear();
-		_magic_key.reserve(256);
+		auto &context = *game_state.decode_context;
+
+		lak::array<uint8_t> magic_key;
+		magic_key.reserve(256);
 
 		if (!game_state.old_game && game_state.product_build <= 285)
 		{
 			if (game_state.game.project_path)
-				_magic_key += KeyString(game_state.game.project_path->value);
-			if (_magic_key.size() < 0x80 && game_state.game.title)
-				_magic_key += KeyString(game_state.game.title->value);
-			if (_magic_key.size() < 0x80 && game_state.game.copyright)
-				_magic_key += KeyString(game_state.game.copyright->value);
+				magic_key += KeyString(game_state.game.project_path->value);
+			if (magic_key.size() < 0x80 && game_state.game.title)
+				magic_key += KeyString(game_state.game.title->value);
+			if (magic_key.size() < 0x80 && game_state.game.copyright)
+				magic_key += KeyString(game_state.game.copyright->value);
 		}
 		else
 		{
 			if (game_state.game.title)
-				_magic_key += KeyString(game_state.game.title->value);
-			if (_magic_key.size() < 0x80 && game_state.game.copyright)
-				_magic_key += KeyString(game_state.game.copyright->value);
-			if (_magic_key.size() < 0x80 && game_state.game.project_path)
-				_magic_key += KeyString(game_state.game.project_path->value);
+				magic_key += KeyString(game_state.game.title->value);
+			if (magic_key.size() < 0x80 && game_state.game.copyright)
+				magic_key += KeyString(game_state.game.copyright->value);
+			if (magic_key.size() < 0x80 && game_state.game.project_path)
+				magic_key += KeyString(game_state.game.project_path->value);
 		}
-		_magic_key.resize(0x100, 0U);
-		std::memset(_magic_key.data() + 0x80, 0, 0x80);
+		magic_key.resize(0x100, 0U);
+		std::memset(magic_key.data() + 0x80, 0, 0x80);
 
-		uint8_t *key_ptr = _magic_key.data();
+		uint8_t *key_ptr = magic_key.data();
 		size_t len       = strlen((char *)key_ptr);
-		uint8_t accum    = _magic_char;
-		uint8_t hash     = _magic_char;
+		uint8_t accum    = context.magic_char();
+		uint8_t hash     = context.magic_char();
 		for (size_t i = 0; i <= len; ++i)
 		{
 			hash = (hash << 7) + (hash >> 1);
@@ -227,18 +244,17 @@ namespace SourceExplorer
 		}
 		*key_ptr = accum;
 
-		decryptor.valid = false;
+		context.set_magic_key(lak::move(magic_key));
 	}
 
-	bool DecodeChunk(lak::span<byte_t> chunk)
+	void PrepareDecryption(game_t &game_state)
 	{
-		if (!decryptor.valid)
-		{
-			if (!decryptor.init(lak::span(_magic_key).first<0x100>(), _magic_char))
-				return false;
-		}
+		auto &context = *game_state.decode_context;
+
+		if (!context.has_magic_key()) GetEncryptionKey(game_state);
 
-		return decryptor.decode(chunk);
+		// Decoding an empty chunk just creates the decryption table.
+		context.decode_chunk(lak::span<byte_t>{});
 	}
 
 	result_t<image_section_header_t> ParseImageSectionHeader(data_reader_t &strm)
@@ -782,11 +798,20 @@ namespace SourceExplorer
 			colors[i] = ColorFrom8bitA(uint8_t(A[i]));
 	}
 
+	// The colour kernels work on raw RGBA bytes.
+	static_assert(sizeof(lak::color4_t) == 4);
+
+	static byte_t *RGBABytes(lak::span<lak::color4_t> colors)
+	{
+		return reinterpret_cast<byte_t *>(colors.data());
+	}
+
 	void MaskFrom8bitA(lak::span<lak::color4_t> colors,
 	                   lak::span<const byte_t> A)
 	{
 		ASSERT_EQUAL(colors.size(), A.size());
-		for (size_t i = 0; i < colors.size(); ++i) colors[i].a = uint8_t(A[i]);
+		color_kernels().mask_from_8bit_a(
+		  RGBABytes(colors), A.data(), colors.size());
 	}
 
 	void ColorsFrom8bitI(lak::span<lak::color4_t> colors,
@@ -794,78 +819,59 @@ namespace SourceExplorer
 	                     lak::span<const lak::color4_t, 256> palette)
 	{
 		ASSERT_EQUAL(colors.size(), index.size());
-		for (size_t i = 0; i < colors.size(); ++i)
-			colors[i] = palette[uint8_t(index[i])];
+		color_kernels().from_8bit_i(
+		  RGBABytes(colors),
+		  index.data(),
+		  reinterpret_cast<const byte_t *>(palette.data()),
+		  colors.size());
 	}
 
 	void ColorsFrom15bitRGB(lak::span<lak::color4_t> colors,
 	                        lak::span<const byte_t> RGB)
 	{
 		ASSERT_EQUAL(colors.size() * 2, RGB.size());
-		for (size_t i = 0; i < colors.size(); ++i)
-			colors[i] = ColorFrom15bitRGB(uint16_t(uint8_t(RGB[(i * 2) + 0])) |
-			                              uint16_t(uint8_t(RGB[(i * 2) + 1]) << 8));
+		color_kernels().from_15bit_rgb(
+		  RGBABytes(colors), RGB.data(), colors.size());
 	}
 
 	void ColorsFrom16bitRGB(lak::span<lak::color4_t> colors,
 	                        lak::span<const byte_t> RGB)
 	{
 		ASSERT_EQUAL(colors.size() * 2, RGB.size());
-		for (size_t i = 0; i < colors.size(); ++i)
-			colors[i] = ColorFrom16bitRGB(uint16_t(uint8_t(RGB[(i * 2) + 0])) |
-			                              uint16_t(uint8_t(RGB[(i * 2) + 1]) << 8));
+		color_kernels().from_16bit_rgb(
+		  RGBABytes(colors), RGB.data(), colors.size());
 	}
 
 	void ColorsFrom24bitBGR(lak::span<lak::color4_t> colors,
 	                        lak::span<const byte_t> BGR)
 	{
 		ASSERT_EQUAL(colors.size() * 3, BGR.size());
-		for (size_t i = 0; i < colors.size(); ++i)
-		{
-			colors[i].b = uint8_t(BGR[(i * 3) + 0]);
-			colors[i].g = uint8_t(BGR[(i * 3) + 1]);
-			colors[i].r = uint8_t(BGR[(i * 3) + 2]);
-			colors[i].a = 255;
-		}
+		color_kernels().from_24bit_bgr(
+		  RGBABytes(colors), BGR.data(), colors.size());
 	}
 
 	void ColorsFrom32bitBGR(lak::span<lak::color4_t> colors,
 	                        lak::span<const byte_t> BGR)
 	{
 		ASSERT_EQUAL(colors.size() * 4, BGR.size());
-		for (size_t i = 0; i < colors.size(); ++i)
-		{
-			colors[i].b = uint8_t(BGR[(i * 4) + 0]);
-			colors[i].g = uint8_t(BGR[(i * 4) + 1]);
-			colors[i].r = uint8_t(BGR[(i * 4) + 2]);
-			colors[i].a = 255;
-		}
+		color_kernels().from_32bit_bgr(
+		  RGBABytes(colors), BGR.data(), colors.size());
 	}
 
 	void ColorsFrom32bitBGRA(lak::span<lak::color4_t> colors,
 	                         lak::span<const byte_t> BGR)
 	{
 		ASSERT_EQUAL(colors.size() * 4, BGR.size());
-		for (size_t i = 0; i < colors.size(); ++i)
-		{
-			colors[i].b = uint8_t(BGR[(i * 4) + 0]);
-			colors[i].g = uint8_t(BGR[(i * 4) + 1]);
-			colors[i].r = uint8_t(BGR[(i * 4) + 2]);
-			colors[i].a = uint8_t(BGR[(i * 4) + 3]);
-		}
+		color_kernels().from_32bit_bgra(
+		  RGBABytes(colors), BGR.data(), colors.size());
 	}
 
 	void ColorsFrom24bitRGB(lak::span<lak::color4_t> colors,
 	                        lak::span<const byte_t> RGB)
 	{
 		ASSERT_EQUAL(colors.size() * 3, RGB.size());
-		for (size_t i = 0; i < colors.size(); ++i)
-		{
-			colors[i].r = uint8_t(RGB[(i * 3) + 0]);
-			colors[i].g = uint8_t(RGB[(i * 3) + 1]);
-			colors[i].b = uint8_t(RGB[(i * 3) + 2]);
-			colors[i].a = 255;
-		}
+		color_kernels().from_24bit_rgb(
+		  RGBABytes(colors), RGB.data(), colors.size());
 	}
 
 	void ColorsFrom32bitRGB(lak::span<lak::color4_t> colors,
@@ -1050,26 +1056,141 @@ namespace SourceExplorer
 		}
 	}
 
-	result_t<size_t> ReadRLE(data_reader_t &strm,
-	                         lak::image4_t &bitmap,
-	                         graphics_mode_t mode,
-	                         uint16_t padding,
-	                         const lak::color4_t palette[256])
+	// Converts packed pixels of a graphics mode known at compile time.
+	template<graphics_mode_t MODE>
+	static void ColorsFromMode(lak::span<lak::color4_t> colors,
+	                           lak::span<const byte_t> bytes,
+	                           const lak::color4_t palette[256])
+	{
+		if constexpr (MODE == graphics_mode_t::RGBA32)
+			ColorsFrom32bitRGBA(colors, bytes);
+		else if constexpr (MODE == graphics_mode_t::BGRA32)
+			ColorsFrom32bitBGRA(colors, bytes);
+		else if constexpr (MODE == graphics_mode_t::RGB24)
+			ColorsFrom24bitRGB(colors, bytes);
+		else if constexpr (MODE == graphics_mode_t::RGB16)
+			ColorsFrom16bitRGB(colors, bytes);
+		else if constexpr (MODE == graphics_mode_t::RGB15)
+			ColorsFrom15bitRGB(colors, bytes);
+		else if constexpr (MODE == graphics_mode_t::RGB8)
+		{
+			if (palette)
+				ColorsFrom8bitI(colors,
+				                bytes,
+				                lak::span<const lak::color4_t, 256>::from_ptr(palette));
+			else
+				ColorsFrom8bitRGB(colors, bytes);
+		}
+		else
+			ColorsFrom24bitBGR(colors, bytes);
+	}
+
+	static void ColorsFromMode(lak::span<lak::color4_t> colors,
+	                           lak::span<const byte_t> bytes,
+	                           graphics_mode_t mode,
+	                           const lak::color4_t palette[256])
 	{
-		FUNCTION_CHECKPOINT();
+		switch (mode)
+		{
+			case graphics_mode_t::RGBA32:
+				return ColorsFromMode<graphics_mode_t::RGBA32>(colors, bytes, palette);
+			case graphics_mode_t::BGRA32:
+				return ColorsFromMode<graphics_mode_t::BGRA32>(colors, bytes, palette);
 
-		const size_t point_size = ColorModeSize(mode);
+			case graphics_mode_t::RGB24:
+				return ColorsFromMode<graphics_mode_t::RGB24>(colors, bytes, palette);
+			case graphics_mode_t::BGR24:
+				return ColorsFromMode<graphics_mode_t::BGR24>(colors, bytes, palette);
 
-		DEBUG("Point Size: ", point_size);
-		DEBUG("Padding: ", padding);
+			case graphics_mode_t::RGB16:
+				return ColorsFromMode<graphics_mode_t::RGB16>(colors, bytes, palette);
+			case graphics_mode_t::RGB15:
+				return ColorsFromMode<graphics_mode_t::RGB15>(colors, bytes, palette);
+
+			case graphics_mode_t::RGB8:
+				return ColorsFromMode<graphics_mode_t::RGB8>(colors, bytes, palette);
+
+			default:
+				return ColorsFromMode<graphics_mode_t::BGR24>(colors, bytes, palette);
+		}
+	}
+
+	// Whether colours decoded from mode can have an alpha other than 255.
+	static constexpr bool ModeHasAlpha(graphics_mode_t mode)
+	{
+		return mode == graphics_mode_t::RGBA32 ||
+		       mode == graphics_mode_t::BGRA32 || mode == graphics_mode_t::RGB8;
+	}
+
+	// Sets the alpha of freshly decoded colours, while they're still in cache.
+	static void ApplyAlphaMode(lak::span<lak::color4_t> colors,
+	                           bool has_alpha,
+	                           alpha_mode_t alpha_mode,
+	                           const lak::color4_t &transparent)
+	{
+		switch (alpha_mode)
+		{
+			case alpha_mode_t::decoded:
+				break;
+
+			case alpha_mode_t::opaque:
+				if (has_alpha)
+					for (auto &color : colors) color.a = 255;
+				break;
 
-		size_t pos = 0;
-		size_t i   = 0;
+			case alpha_mode_t::transparent:
+				for (auto &color : colors)
+					color.a = lak::color3_t(color) == lak::color3_t(transparent)
+					            ? transparent.a
+					            : 255;
+				break;
+		}
+	}
+
+	// PADDED is false when padding is 0, in which case rows are contiguous and
+	// runs never need to be split at the end of a row.
+	template<graphics_mode_t MODE, bool PADDED>
+	static result_t<size_t> ReadRLEImpl(data_reader_t &strm,
+	                                    image_span_t bitmap,
+	                                    uint16_t padding,
+	                                    const lak::color4_t palette[256],
+	                                    alpha_mode_t alpha_mode,
+	                                    const lak::color4_t &transparent)
+	{
+		const size_t point_size = ColorModeSize(MODE);
+		const size_t width      = bitmap.size().x;
+		const size_t stride     = width + padding;
+		const size_t pixels     = bitmap.contig_size();
 
 		size_t start = strm.position();
+		size_t i     = 0;
+		// Column of the next point, including the padding at the end of rows.
+		size_t column = 0;
 
-		DEBUG_EXPR(strm.remaining().size());
-		DEBUG_EXPR(((bitmap.size().x * point_size) + padding) * bitmap.size().y);
+		// Calls fill(offset, count) for each part of the next length points
+		// that lands in the bitmap, skipping the padding at the end of rows.
+		auto for_each_part = [&](size_t length, auto &&fill)
+		{
+			if constexpr (!PADDED)
+			{
+				fill(size_t(0), length);
+			}
+			else
+			{
+				for (size_t offset = 0; offset < length;)
+				{
+					const size_t count =
+					  std::min(length - offset,
+					           column < width ? width - column : stride - column);
+					if (column < width) fill(offset, count);
+					offset += count;
+					column += count;
+					if (column == stride) column = 0;
+				}
+			}
+		};
+
+		lak::color4_t repeated;
 
 		while (true)
 		{
@@ -1080,41 +1201,123 @@ namespace SourceExplorer
 			if (command > 128)
 			{
 				command -= 128;
-				for (uint8_t n = 0; n < command; ++n)
-				{
-					if ((pos++) % (bitmap.size().x + padding) < bitmap.size().x)
-					{
-						RES_TRY_ASSIGN(bitmap[i++] =, ColorFromMode(strm, mode, palette));
-					}
-					else
-					{
-						TRY(strm.skip(point_size));
-					}
-				}
+				CHECK_REMAINING(strm, command * point_size);
+				const auto bytes = strm.remaining().first(command * point_size);
+				strm.skip(bytes.size()).UNWRAP();
+				for_each_part(command,
+				              [&](size_t offset, size_t count)
+				              {
+					              const size_t n = std::min(count, pixels - i);
+					              const lak::span colors(bitmap.data() + i, n);
+					              ColorsFromMode<MODE>(
+					                colors,
+					                bytes.subspan(offset * point_size, n * point_size),
+					                palette);
+					              ApplyAlphaMode(
+					                colors, ModeHasAlpha(MODE), alpha_mode, transparent);
+					              i += n;
+				              });
 			}
 			else
 			{
-				RES_TRY_ASSIGN(lak::color4_t col =,
-				               ColorFromMode(strm, mode, palette));
-				for (uint8_t n = 0; n < command; ++n)
-				{
-					if ((pos++) % (bitmap.size().x + padding) < bitmap.size().x)
-						bitmap[i++] = col;
-				}
+				CHECK_REMAINING(strm, point_size);
+				ColorsFromMode<MODE>(
+				  lak::span(&repeated, 1), strm.remaining().first(point_size), palette);
+				strm.skip(point_size).UNWRAP();
+				// The whole run shares one colour, so its alpha only needs setting
+				// once.
+				ApplyAlphaMode(lak::span(&repeated, 1),
+				               ModeHasAlpha(MODE),
+				               alpha_mode,
+				               transparent);
+				for_each_part(command,
+				              [&](size_t, size_t count)
+				              {
+					              const size_t n = std::min(count, pixels - i);
+					              std::fill_n(bitmap.data() + i, n, repeated);
+					              i += n;
+				              });
 			}
 		}
 
-		if (i != bitmap.contig_size())
-			ERROR("Only Filled ", i, " Pixels Of ", bitmap.contig_size());
+		if (i != pixels) ERROR("Only Filled ", i, " Pixels Of ", pixels);
 
 		return lak::ok_t{strm.position() - start};
 	}
 
+	template<graphics_mode_t MODE>
+	static result_t<size_t> ReadRLEMode(data_reader_t &strm,
+	                                    image_span_t bitmap,
+	                                    uint16_t padding,
+	                                    const lak::color4_t palette[256],
+	                                    alpha_mode_t alpha_mode,
+	                                    const lak::color4_t &transparent)
+	{
+		if (padding == 0)
+			return ReadRLEImpl<MODE, false>(
+			  strm, bitmap, padding, palette, alpha_mode, transparent);
+		else
+			return ReadRLEImpl<MODE, true>(
+			  strm, bitmap, padding, palette, alpha_mode, transparent);
+	}
+
+	result_t<size_t> ReadRLE(data_reader_t &strm,
+	                         image_span_t bitmap,
+	                         graphics_mode_t mode,
+	                         uint16_t padding,
+	                         const lak::color4_t palette[256],
+	                         alpha_mode_t alpha_mode,
+	                         const lak::color4_t &transparent)
+	{
+		FUNCTION_CHECKPOINT();
+
+		DEBUG("Point Size: ", size_t(ColorModeSize(mode)));
+		DEBUG("Padding: ", padding);
+
+		DEBUG_EXPR(strm.remaining().size());
+		DEBUG_EXPR(((bitmap.size().x * ColorModeSize(mode)) + padding) *
+		           bitmap.size().y);
+
+		switch (mode)
+		{
+			case graphics_mode_t::RGBA32:
+				return ReadRLEMode<graphics_mode_t::RGBA32>(
+				  strm, bitmap, padding, palette, alpha_mode, transparent);
+			case graphics_mode_t::BGRA32:
+				return ReadRLEMode<graphics_mode_t::BGRA32>(
+				  strm, bitmap, padding, palette, alpha_mode, transparent);
+
+			case graphics_mode_t::RGB24:
+				return ReadRLEMode<graphics_mode_t::RGB24>(
+				  strm, bitmap, padding, palette, alpha_mode, transparent);
+			case graphics_mode_t::BGR24:
+				return ReadRLEMode<graphics_mode_t::BGR24>(
+				  strm, bitmap, padding, palette, alpha_mode, transparent);
+
+			case graphics_mode_t::RGB16:
+				return ReadRLEMode<graphics_mode_t::RGB16>(
+				  strm, bitmap, padding, palette, alpha_mode, transparent);
+			case graphics_mode_t::RGB15:
+				return ReadRLEMode<graphics_mode_t::RGB15>(
+				  strm, bitmap, padding, palette, alpha_mode, transparent);
+
+			case graphics_mode_t::RGB8:
+				return ReadRLEMode<graphics_mode_t::RGB8>(
+				  strm, bitmap, padding, palette, alpha_mode, transparent);
+
+			default:
+				return ReadRLEMode<graphics_mode_t::BGR24>(
+				  strm, bitmap, padding, palette, alpha_mode, transparent);
+		}
+	}
+
 	result_t<size_t> ReadRGB(data_reader_t &strm,
-	                         lak::image4_t &bitmap,
+	                         image_span_t bitmap,
 	                         graphics_mode_t mode,
 	                         uint16_t padding,
-	                         const lak::color4_t palette[256])
+	                         const lak::color4_t palette[256],
+	                         alpha_mode_t alpha_mode,
+	                         const lak::color4_t &transparent)
 	{
 		FUNCTION_CHECKPOINT();
 
@@ -1131,21 +1334,29 @@ namespace SourceExplorer
 		  strm, ((bitmap.size().x * point_size) + padding) * bitmap.size().y);
 
 		const lak::span bitmap_span{bitmap.data(), bitmap.contig_size()};
+		const bool has_alpha = ModeHasAlpha(mode);
 
 		if (padding == 0)
 		{
-			ColorsFromMode(bitmap_span, strm, mode, palette).UNWRAP();
+			// Converted a cache sized block at a time so the alpha can be set
+			// before the colours are evicted.
+			const size_t block_size = 0x1000;
+			for (size_t i = 0; i < bitmap_span.size(); i += block_size)
+			{
+				const auto colors = bitmap_span.subspan(
+				  i, std::min(block_size, bitmap_span.size() - i));
+				ColorsFromMode(colors, strm, mode, palette).UNWRAP();
+				ApplyAlphaMode(colors, has_alpha, alpha_mode, transparent);
+			}
 		}
 		else
 		{
 			for (size_t y = 0; y < bitmap.size().y; ++y)
 			{
-				ColorsFromMode(
-				  bitmap_span.subspan(y * bitmap.size().x, bitmap.size().x),
-				  strm,
-				  mode,
-				  palette)
-				  .UNWRAP();
+				const auto row =
+				  bitmap_span.subspan(y * bitmap.size().x, bitmap.size().x);
+				ColorsFromMode(row, strm, mode, palette).UNWRAP();
+				ApplyAlphaMode(row, has_alpha, alpha_mode, transparent);
 				strm.skip(padding).UNWRAP();
 			}
 		}
@@ -1154,7 +1365,7 @@ namespace SourceExplorer
 	}
 
 	result_t<size_t> ReadAlpha(data_reader_t &strm,
-	                           lak::image4_t &bitmap,
+	                           image_span_t bitmap,
 	                           uint16_t padding)
 	{
 		FUNCTION_CHECKPOINT();
@@ -1185,16 +1396,272 @@ namespace SourceExplorer
 		return lak::ok_t{strm.position() - start};
 	}
 
-	void ReadTransparent(const lak::color4_t &transparent, lak::image4_t &bitmap)
+	void ReadTransparent(const lak::color4_t &transparent, image_span_t bitmap)
 	{
 		FUNCTION_CHECKPOINT();
 
-		for (size_t i = 0; i < bitmap.contig_size(); ++i)
+		ApplyAlphaMode(lak::span(bitmap.data(), bitmap.contig_size()),
+		               true,
+		               alpha_mode_t::transparent,
+		               transparent);
+	}
+
+	image_decoder_t::image_decoder_t(image_span_t bitmap,
+	                                 graphics_mode_t mode,
+	                                 bool rle,
+	                                 uint16_t padding,
+	                                 const lak::color4_t palette[256],
+	                                 alpha_mode_t alpha_mode,
+	                                 const lak::color4_t &transparent,
+	                                 bool alpha_mask,
+	                                 uint16_t alpha_padding)
+	: bitmap(bitmap),
+	  mode(mode),
+	  rle(rle),
+	  padding(padding),
+	  palette(palette),
+	  alpha_mode(alpha_mode),
+	  transparent(transparent),
+	  alpha_mask(alpha_mask),
+	  alpha_padding(alpha_padding)
+	{
+		// Uncompressed colour data has no end marker, so an empty image is
+		// finished before it starts.
+		if (!rle && bitmap.contig_size() == 0) finish_color();
+	}
+
+	size_t image_decoder_t::push(lak::span<const byte_t> data)
+	{
+		size_t used = 0;
+		while (!finished() && used < data.size())
+		{
+			const auto remaining = data.subspan(used);
+			const size_t unit    = unit_size();
+			if (carry_size == 0 && remaining.size() >= unit)
+			{
+				used += decode(remaining);
+				continue;
+			}
+
+			// Collect a unit that is split between pieces of data.
+			const size_t count = std::min(unit - carry_size, remaining.size());
+			std::memcpy(carry + carry_size, remaining.data(), count);
+			carry_size += count;
+			used += count;
+			if (carry_size < unit) break;
+
+			[[maybe_unused]] const size_t decoded =
+			  decode(lak::span<const byte_t>(carry, carry_size));
+			ASSERT_EQUAL(decoded, unit);
+			carry_size = 0;
+		}
+		return used;
+	}
+
+	size_t image_decoder_t::unit_size() const
+	{
+		switch (stage)
+		{
+			case stage_t::color:
+				if (rle)
+					return run_length > 0 ? ColorModeSize(mode) : 1;
+				else
+					return column < bitmap.size().x * ColorModeSize(mode)
+					         ? ColorModeSize(mode)
+					         : 1;
+
+			default:
+				return 1;
+		}
+	}
+
+	size_t image_decoder_t::decode(lak::span<const byte_t> data)
+	{
+		switch (stage)
+		{
+			case stage_t::color:
+				return rle ? decode_rle(data) : decode_rgb(data);
+			case stage_t::alpha:
+				return decode_alpha(data);
+			default:
+				return 0;
+		}
+	}
+
+	void image_decoder_t::finish_color()
+	{
+		column = 0;
+		pixel  = 0;
+		if (alpha_mask && bitmap.contig_size() > 0)
+			stage = stage_t::alpha;
+		else
+			stage = stage_t::finished;
+	}
+
+	size_t image_decoder_t::decode_rgb(lak::span<const byte_t> data)
+	{
+		const size_t point_size = ColorModeSize(mode);
+		const size_t width      = bitmap.size().x;
+		const size_t row_size   = width * point_size;
+		const size_t stride     = row_size + padding;
+		const bool has_alpha    = ModeHasAlpha(mode);
+
+		size_t used = 0;
+		while (used < data.size())
 		{
-			bitmap[i].a = lak::color3_t(bitmap[i]) == lak::color3_t(transparent)
-			                ? transparent.a
-			                : 255;
+			if (column < row_size)
+			{
+				const size_t count = std::min((row_size - column) / point_size,
+				                              (data.size() - used) / point_size);
+				if (count == 0) break;
+				const lak::span colors(bitmap.data() + pixel, count);
+				ColorsFromMode(colors,
+				               data.subspan(used, count * point_size),
+				               mode,
+				               palette);
+				ApplyAlphaMode(colors, has_alpha, alpha_mode, transparent);
+				pixel += count;
+				used += count * point_size;
+				column += count * point_size;
+			}
+			else
+			{
+				const size_t count = std::min(stride - column, data.size() - used);
+				used += count;
+				column += count;
+			}
+
+			if (column == stride)
+			{
+				column = 0;
+				if (pixel == bitmap.contig_size())
+				{
+					finish_color();
+					break;
+				}
+			}
 		}
+		return used;
+	}
+
+	size_t image_decoder_t::decode_rle(lak::span<const byte_t> data)
+	{
+		const size_t point_size = ColorModeSize(mode);
+		const size_t width      = bitmap.size().x;
+		const size_t stride     = width + padding;
+		const size_t pixels     = bitmap.contig_size();
+		const bool has_alpha    = ModeHasAlpha(mode);
+
+		// Calls fill(offset, count) for each part of the next length points
+		// that lands in the bitmap, skipping the padding at the end of rows.
+		auto for_each_part = [&](size_t length, auto &&fill)
+		{
+			for (size_t offset = 0; offset < length;)
+			{
+				const size_t count =
+				  std::min(length - offset,
+				           column < width ? width - column : stride - column);
+				if (column < width) fill(offset, std::min(count, pixels - pixel));
+				offset += count;
+				column += count;
+				if (column == stride) column = 0;
+			}
+		};
+
+		size_t used = 0;
+		while (used < data.size())
+		{
+			if (run_length == 0)
+			{
+				const uint8_t command = uint8_t(data[used++]);
+
+				if (command == 0)
+				{
+					if (pixel != pixels)
+						ERROR("Only Filled ", pixel, " Pixels Of ", pixels);
+					finish_color();
+					break;
+				}
+
+				run_repeat = command <= 128;
+				run_length = run_repeat ? command : command - 128;
+			}
+			else if (run_repeat)
+			{
+				if (data.size() - used < point_size) break;
+				lak::color4_t repeated;
+				ColorsFromMode(lak::span(&repeated, 1),
+				               data.subspan(used, point_size),
+				               mode,
+				               palette);
+				ApplyAlphaMode(
+				  lak::span(&repeated, 1), has_alpha, alpha_mode, transparent);
+				used += point_size;
+				for_each_part(run_length,
+				              [&](size_t, size_t count)
+				              {
+					              std::fill_n(bitmap.data() + pixel, count, repeated);
+					              pixel += count;
+				              });
+				run_length = 0;
+			}
+			else
+			{
+				const size_t count =
+				  std::min(run_length, (data.size() - used) / point_size);
+				if (count == 0) break;
+				const auto bytes = data.subspan(used, count * point_size);
+				for_each_part(count,
+				              [&](size_t offset, size_t n)
+				              {
+					              const lak::span colors(bitmap.data() + pixel, n);
+					              ColorsFromMode(
+					                colors,
+					                bytes.subspan(offset * point_size, n * point_size),
+					                mode,
+					                palette);
+					              ApplyAlphaMode(
+					                colors, has_alpha, alpha_mode, transparent);
+					              pixel += n;
+				              });
+				used += count * point_size;
+				run_length -= count;
+			}
+		}
+		return used;
+	}
+
+	size_t image_decoder_t::decode_alpha(lak::span<const byte_t> data)
+	{
+		const size_t width  = bitmap.size().x;
+		const size_t stride = width + alpha_padding;
+
+		size_t used = 0;
+		while (used < data.size())
+		{
+			const size_t count =
+			  std::min((column < width ? width : stride) - column,
+			           data.size() - used);
+			if (column < width)
+			{
+				MaskFrom8bitA(lak::span(bitmap.data() + pixel, count),
+				              data.subspan(used, count));
+				pixel += count;
+			}
+			used += count;
+			column += count;
+
+			if (column == stride)
+			{
+				column = 0;
+				if (pixel == bitmap.contig_size())
+				{
+					stage = stage_t::finished;
+					break;
+				}
+			}
+		}
+		return used;
 	}
 
 	texture_t CreateTexture(const lak::image4_t &bitmap,
@@ -1687,7 +2154,9 @@ namespace SourceExplorer
 
 	result_t<data_ref_span_t> Decode(data_ref_span_t encoded,
 	                                 chunk_t id,
-	                                 encoding_t mode)
+	                                 encoding_t mode,
+	                                 decode_context_t *context,
+	                                 size_t max_size)
 	{
 		FUNCTION_CHECKPOINT();
 
@@ -1695,28 +2164,35 @@ namespace SourceExplorer
 		{
 			case encoding_t::mode3:
 			case encoding_t::mode2:
-				return Decrypt(encoded, id, mode);
+				return Decrypt(encoded, id, mode, context, max_size);
 			case encoding_t::mode1:
 				return lak::ok_t{
-				  lak::ok_or_err(Inflate(encoded, false, false)
+				  lak::ok_or_err(Inflate(encoded, false, false, max_size)
 				                   .map_err([&](auto &&) { return encoded; }))};
 			default:
-				if (encoded.size() > 0 && uint8_t(encoded[0]) == 0x78)
+				if (LooksCompressed(encoded))
 					return lak::ok_t{
-					  lak::ok_or_err(Inflate(encoded, false, false)
+					  lak::ok_or_err(Inflate(encoded, false, false, max_size)
 					                   .map_err([&](auto &&) { return encoded; }))};
 				else
 					return lak::ok_t{encoded};
 		}
 	}
 
-	result_t<data_ref_span_t> Inflate(data_ref_span_t compressed,
-	                                  bool skip_header,
-	                                  bool anaconda,
-	                                  size_t max_size)
+	bool LooksCompressed(lak::span<const byte_t> data, bool partial)
 	{
-		FUNCTION_CHECKPOINT();
+		return data.size() > 0 && uint8_t(data[0]) == 0x78 &&
+		       IsZlibStream(data, partial);
+	}
 
+	// Passes each block of inflated data to sink until either the stream
+	// ends or sink returns false.
+	template<typename SINK>
+	static error_t InflateImpl(lak::span<const byte_t> compressed,
+	                           bool skip_header,
+	                           bool anaconda,
+	                           SINK &&sink)
+	{
 		lak::array<byte_t, 0x8000> buffer;
 		auto inflater = lak::deflate_iterator(
 		  compressed,
@@ -1725,46 +2201,20 @@ namespace SourceExplorer
 		               : lak::deflate_iterator::header_t::none,
 		  anaconda);
 
-		lak::array<byte_t> output;
-		output.reserve(buffer.size());
-		if (auto err = inflater.read(
-		      [&](lak::span<byte_t> v)
-		      {
-			      bool hit_max = output.size() + v.size() > max_size;
-			      if (hit_max) v = v.first(max_size - output.size());
-			      output.reserve(output.size() + v.size());
-			      for (const byte_t &b : v) output.push_back(b);
-			      if (hit_max) DEBUG("Hit Max");
-			      return !hit_max;
-		      });
-		    err.is_ok())
+		if (auto err = inflater.read(sink); err.is_ok())
 		{
-			return lak::ok_t{make_data_ref_ptr(compressed, lak::move(output))};
+			return lak::ok_t{};
 		}
-// #ifndef NDEBUG
-#if 0
-		else if (err.unsafe_unwrap_err() ==
-		         lak::deflate_iterator::error_t::corrupt_stream)
-		{
-			auto [bytes_read, bits_read] = inflater.bytes_read();
-			ERROR("Corrupt Stream. Bytes Read: ",
-			      bytes_read,
-			      ", Bits Read: ",
-			      bits_read);
-			return lak::ok_t{make_data_ref_ptr(compressed, lak::move(output))};
-		}
-#endif
 		else if (err.unsafe_unwrap_err() == lak::deflate_iterator::error_t::ok)
 		{
 			// This is not (always) an error, we may intentionally stop the decode
 			// early to not waste time and memory.
 
 			CHECKPOINT();
-			return lak::ok_t{make_data_ref_ptr(compressed, lak::move(output))};
+			return lak::ok_t{};
 		}
 		else
 		{
-			DEBUG("Max Size: ", max_size);
 			DEBUG("Final? ", (inflater.is_final_block() ? "True" : "False"));
 			return lak::err_t{error(error_type::inflate_failed,
 			                        lak::streamify("Failed To Inflate (",
@@ -1774,31 +2224,501 @@ namespace SourceExplorer
 		}
 	}
 
+	// Append to an array that has been reserved up to reserved bytes, growing
+	// the reservation geometrically.
+	static void AppendBytes(lak::array<byte_t> &output,
+	                        size_t &reserved,
+	                        lak::span<const byte_t> bytes)
+	{
+		const size_t old_size = output.size();
+		if (old_size + bytes.size() > reserved)
+		{
+			reserved = std::max(old_size + bytes.size(), reserved * 2);
+			output.reserve(reserved);
+		}
+		output.resize(old_size + bytes.size());
+		std::memcpy(output.data() + old_size, bytes.data(), bytes.size());
+	}
+
+	static lak::stack_trace FastInflateError(fast_inflate_error_t err)
+	{
+		return error(
+		  error_type::inflate_failed,
+		  lak::streamify("Failed To Inflate (", fast_inflate_error_name(err), ")"));
+	}
+
+	error_t InflateImage(lak::span<const byte_t> compressed,
+	                     bool skip_header,
+	                     image_decoder_t &decoder)
+	{
+		FUNCTION_CHECKPOINT();
+
+#ifdef SE_FAST_INFLATE
+		RES_TRY(FastInflateStream(compressed,
+		                          skip_header,
+		                          [&](lak::span<const byte_t> output)
+		                          {
+			                          decoder.push(output);
+			                          return !decoder.finished();
+		                          })
+		          .map_err(FastInflateError)
+		          .RES_ADD_TRACE("InflateImage"));
+#else
+		RES_TRY(InflateImpl(compressed,
+		                    skip_header,
+		                    false,
+		                    [&](lak::span<byte_t> output)
+		                    {
+			                    decoder.push(lak::span<const byte_t>(output));
+			                    return !decoder.finished();
+		                    })
+		          .RES_ADD_TRACE("InflateImage"));
+#endif
+
+		if (!decoder.finished())
+			return lak::err_t{error(error_type::out_of_data)};
+
+		return lak::ok_t{};
+	}
+
+	result_t<size_t> InflateInto(lak::span<byte_t> output,
+	                             lak::span<const byte_t> compressed,
+	                             bool skip_header,
+	                             bool anaconda)
+	{
+		FUNCTION_CHECKPOINT();
+
+#ifdef SE_FAST_INFLATE
+		if (!anaconda)
+			return FastInflateInto(output, compressed, skip_header)
+			  .map_err(FastInflateError);
+#endif
+
+		size_t written = 0;
+		RES_TRY(InflateImpl(compressed,
+		                    skip_header,
+		                    anaconda,
+		                    [&](lak::span<byte_t> v)
+		                    {
+			                    const size_t count =
+			                      std::min(v.size(), output.size() - written);
+			                    std::memcpy(
+			                      output.data() + written, v.data(), count);
+			                    written += count;
+			                    return written < output.size();
+		                    })
+		          .RES_ADD_TRACE("InflateInto"));
+		return lak::ok_t{written};
+	}
+
+	result_t<lak::array<byte_t>> InflateRaw(lak::span<const byte_t> compressed,
+	                                        bool skip_header,
+	                                        bool anaconda,
+	                                        size_t max_size,
+	                                        size_t size_hint)
+	{
+		FUNCTION_CHECKPOINT();
+
+#ifdef SE_FAST_INFLATE
+		// Very large streams are split across threads. This is built on the
+		// fast engine, so it can't handle anaconda streams.
+		if (!anaconda && max_size == SIZE_MAX && parallel_inflate_threshold > 0 &&
+		    compressed.size() >= parallel_inflate_threshold)
+		{
+			lak::array<byte_t> output;
+			RES_TRY(
+			  FastInflateParallel(output, compressed, skip_header, 0, size_hint)
+			    .map_err(FastInflateError));
+			return lak::ok_t{lak::move(output)};
+		}
+
+		if (!anaconda)
+		{
+			lak::array<byte_t> output;
+			RES_TRY(
+			  FastInflate(output, compressed, skip_header, max_size, size_hint)
+			    .map_err(FastInflateError));
+			return lak::ok_t{lak::move(output)};
+		}
+#endif
+
+		// The final size is usually known up front, but don't trust it blindly
+		// as it comes straight from the file.
+		size_t reserved = size_hint > 0 ? std::min(size_hint, max_size) : 0x8000;
+		reserved        = std::min(reserved, compressed.size() * 1032 + 0x8000);
+
+		lak::array<byte_t> output;
+		output.reserve(reserved);
+
+		RES_TRY(InflateImpl(compressed,
+		                    skip_header,
+		                    anaconda,
+		                    [&](lak::span<byte_t> v)
+		                    {
+			                    bool hit_max = output.size() + v.size() > max_size;
+			                    if (hit_max) v = v.first(max_size - output.size());
+			                    AppendBytes(output, reserved, v);
+			                    if (hit_max) DEBUG("Hit Max");
+			                    return !hit_max;
+		                    })
+		          .RES_ADD_TRACE("InflateRaw"));
+
+		return lak::ok_t{lak::move(output)};
+	}
+
+	void BenchmarkInflate(game_t &game, const job_ptr_t &job)
+	{
+		FUNCTION_CHECKPOINT();
+
+		lak::array<data_ref_span_t> chunks;
+		size_t compressed_size = 0;
+		auto add_items         = [&](const auto &bank)
+		{
+			if (!bank) return;
+			for (const auto &item : bank->items)
+			{
+				// Old games use the anaconda variant of deflate, which only lak
+				// knows how to decode.
+				if (item.entry.old || item.entry.mode != encoding_t::mode1)
+					continue;
+				chunks.push_back(item.entry.body.data);
+				compressed_size += item.entry.body.data.size();
+			}
+		};
+		add_items(game.game.image_bank);
+		add_items(game.game.sound_bank);
+		add_items(game.game.music_bank);
+		add_items(game.game.font_bank);
+
+		if (chunks.empty())
+		{
+			WARNING("No compressed chunks to benchmark");
+			return;
+		}
+
+		// Both timed loops, the comparison and the parallel check.
+		job->steps += chunks.size() * 4;
+
+		auto time = [&](auto &&inflate)
+		{
+			size_t inflated_size = 0;
+			const auto start     = std::chrono::steady_clock::now();
+			for (const auto &chunk : chunks) inflated_size += inflate(chunk);
+			const auto end = std::chrono::steady_clock::now();
+			job->steps_done += chunks.size();
+			return std::pair<size_t, double>{
+			  inflated_size, std::chrono::duration<double>(end - start).count()};
+		};
+
+		lak::array<byte_t> output;
+
+		const auto [lak_size, lak_seconds] = time(
+		  [&](lak::span<const byte_t> chunk) -> size_t
+		  {
+			  lak::array<byte_t, 0x8000> buffer;
+			  auto inflater = lak::deflate_iterator(
+			    chunk, buffer, lak::deflate_iterator::header_t::zlib, false);
+			  size_t size = 0;
+			  inflater
+			    .read(
+			      [&](lak::span<byte_t> v)
+			      {
+				      size += v.size();
+				      return true;
+			      })
+			    .discard();
+			  return size;
+		  });
+		if (job->cancelled()) return;
+
+		const auto [fast_size, fast_seconds] = time(
+		  [&](lak::span<const byte_t> chunk) -> size_t
+		  {
+			  return lak::ok_or_err(FastInflate(output, chunk, false)
+			                          .map_err([](auto &&) -> size_t { return 0; }));
+		  });
+		if (job->cancelled()) return;
+
+		// Check the engines produce the same bytes outside of the timed loops.
+		size_t mismatches = 0;
+		lak::array<byte_t> lak_output;
+		size_t reserved = 0;
+		for (const auto &chunk : chunks)
+		{
+			if (job->cancelled()) return;
+			++job->steps_done;
+			lak_output.clear();
+			lak::array<byte_t, 0x8000> buffer;
+			auto inflater = lak::deflate_iterator(
+			  chunk, buffer, lak::deflate_iterator::header_t::zlib, false);
+			auto expected = inflater.read(
+			  [&](lak::span<byte_t> v)
+			  {
+				  AppendBytes(lak_output, reserved, v);
+				  return true;
+			  });
+			auto decoded = FastInflate(output, chunk, false);
+			if (expected.is_ok() != decoded.is_ok() ||
+			    lak_output.size() != output.size() ||
+			    !std::equal(lak_output.begin(), lak_output.end(), output.begin()))
+				++mismatches;
+		}
+
+		if (lak_size != fast_size || mismatches > 0)
+			ERROR("Inflate engines disagree: lak ",
+			      lak_size,
+			      " bytes, fast ",
+			      fast_size,
+			      " bytes, ",
+			      mismatches,
+			      " mismatched chunks");
+
+		// Neither engine is charged for copying out the data, lak's output is
+		// only counted and the fast output is reused between chunks.
+		DEBUG("Inflated ",
+		      chunks.size(),
+		      " chunks (",
+		      compressed_size,
+		      " -> ",
+		      lak_size,
+		      " bytes)");
+		DEBUG("lak: ",
+		      lak_seconds * 1000.0,
+		      "ms (",
+		      (lak_size / 1048576.0) / lak_seconds,
+		      " MiB/s)");
+		DEBUG("fast: ",
+		      fast_seconds * 1000.0,
+		      "ms (",
+		      (fast_size / 1048576.0) / fast_seconds,
+		      " MiB/s)");
+
+		// Check the parallel inflater against the serial one on the chunks big
+		// enough for it to split.
+		size_t parallel_count      = 0;
+		size_t parallel_mismatches = 0;
+		double serial_seconds      = 0.0;
+		double parallel_seconds    = 0.0;
+		lak::array<byte_t> parallel_output;
+		for (const auto &chunk : chunks)
+		{
+			if (job->cancelled()) return;
+			++job->steps_done;
+			if (chunk.size() < 0x200000) continue;
+			++parallel_count;
+
+			const auto start = std::chrono::steady_clock::now();
+			auto serial      = FastInflate(output, chunk, false);
+			const auto mid   = std::chrono::steady_clock::now();
+			auto parallel    = FastInflateParallel(parallel_output, chunk, false);
+			const auto end   = std::chrono::steady_clock::now();
+
+			serial_seconds += std::chrono::duration<double>(mid - start).count();
+			parallel_seconds += std::chrono::duration<double>(end - mid).count();
+
+			if (serial.is_ok() != parallel.is_ok() ||
+			    output.size() != parallel_output.size() ||
+			    !std::equal(output.begin(), output.end(), parallel_output.begin()))
+				++parallel_mismatches;
+		}
+
+		if (parallel_count > 0)
+		{
+			if (parallel_mismatches > 0)
+				ERROR("Parallel inflate disagrees with serial inflate on ",
+				      parallel_mismatches,
+				      " of ",
+				      parallel_count,
+				      " chunks");
+			DEBUG("serial: ",
+			      serial_seconds * 1000.0,
+			      "ms, parallel: ",
+			      parallel_seconds * 1000.0,
+			      "ms (",
+			      parallel_count,
+			      " chunks)");
+		}
+	}
+
+	result_t<data_ref_span_t> Inflate(data_ref_span_t compressed,
+	                                  bool skip_header,
+	                                  bool anaconda,
+	                                  size_t max_size,
+	                                  size_t size_hint)
+	{
+		RES_TRY_ASSIGN(
+		  auto output =,
+		  InflateRaw(compressed, skip_header, anaconda, max_size, size_hint));
+		return lak::ok_t{make_data_ref_ptr(compressed, lak::move(output))};
+	}
+
 	result_t<data_ref_span_t> LZ4Decode(data_ref_span_t compressed,
 	                                    unsigned int out_size)
 	{
 		FUNCTION_CHECKPOINT();
 
-		lak::binary_reader reader(compressed);
-
-		return lak::decode_lz4_block(reader, out_size)
-		  .map_err(lak::lz4_error_name)
+		// Decode straight into a buffer of the final size rather than growing
+		// one as the block is decoded. The size comes straight from the file,
+		// so don't trust it past what the block could possibly decode to.
+		lak::array<byte_t> output;
+		output.resize(std::min<size_t>(out_size, compressed.size() * 255 + 16));
+		return FastLZ4DecodeInto(lak::span(output), compressed)
+		  .map_err(fast_lz4_error_name)
 		  .map(
-		    [&](auto &&decompressed)
+		    [&](size_t size) -> data_ref_span_t
 		    {
-			    return data_ref_span_t(
-			      make_data_ref_ptr(compressed, lak::move(decompressed)));
+			    if (size != out_size)
+				    WARNING("Actual decoded size (",
+				            size,
+				            ") was not equal to the expected size (",
+				            out_size,
+				            ").");
+			    output.resize(size);
+			    return make_data_ref_ptr(compressed, lak::move(output));
 		    })
 		  .RES_MAP_TO_TRACE(error_type::inflate_failed);
 	}
 
-	result_t<data_ref_span_t> LZ4DecodeReadSize(data_ref_span_t compressed)
+	result_t<data_ref_span_t> LZ4DecodeReadSize(data_ref_span_t compressed,
+	                                            size_t max_size)
 	{
 		// intentionally doing this outside of the LZ4Decode call incase strm
 		// copies first (?)
 		data_reader_t strm(compressed);
 		TRY_ASSIGN(const uint32_t out_size =, strm.read_u32());
-		return LZ4Decode(strm.read_remaining_ref_span(), out_size);
+
+		// Decoding stops once the output is full, so a smaller output only
+		// decodes the start of the block.
+		return LZ4Decode(strm.read_remaining_ref_span(),
+		                 (unsigned int)std::min<size_t>(out_size, max_size));
+	}
+
+	void BenchmarkLZ4(game_t &game, const job_ptr_t &job)
+	{
+		FUNCTION_CHECKPOINT();
+
+		struct block_t
+		{
+			data_ref_span_t data;
+			uint32_t out_size;
+		};
+		lak::array<block_t> blocks;
+		size_t compressed_size = 0;
+		auto add_items         = [&](const auto &bank)
+		{
+			if (!bank) return;
+			for (const auto &item : bank->items)
+			{
+				if (item.entry.old || item.entry.mode != encoding_t::mode4)
+					continue;
+				data_reader_t strm(item.entry.body.data);
+				if (auto out_size = strm.read_u32(); out_size.is_ok())
+				{
+					blocks.push_back(
+					  {strm.read_remaining_ref_span(), out_size.unsafe_unwrap()});
+					compressed_size += blocks.back().data.size();
+				}
+			}
+		};
+		add_items(game.game.image_bank);
+		add_items(game.game.sound_bank);
+		add_items(game.game.music_bank);
+		add_items(game.game.font_bank);
+
+		if (blocks.empty())
+		{
+			WARNING("No LZ4 compressed items to benchmark");
+			return;
+		}
+
+		// Both timed loops and the comparison.
+		job->steps += blocks.size() * 3;
+
+		auto time = [&](auto &&decode)
+		{
+			size_t decoded_size = 0;
+			const auto start    = std::chrono::steady_clock::now();
+			for (const auto &block : blocks) decoded_size += decode(block);
+			const auto end = std::chrono::steady_clock::now();
+			job->steps_done += blocks.size();
+			return std::pair<size_t, double>{
+			  decoded_size, std::chrono::duration<double>(end - start).count()};
+		};
+
+		const auto [lak_size, lak_seconds] = time(
+		  [&](const block_t &block) -> size_t
+		  {
+			  lak::binary_reader reader(block.data);
+			  return lak::ok_or_err(
+			    lak::decode_lz4_block(reader, block.out_size)
+			      .map([](const auto &output) { return output.size(); })
+			      .map_err([](auto &&) -> size_t { return 0; }));
+		  });
+		if (job->cancelled()) return;
+
+		// The fast decoder gets a buffer that is reused between blocks, as it
+		// would from LZ4DecodeReadSize's caller supplied output.
+		lak::array<byte_t> output;
+		size_t mismatches = 0;
+
+		const auto [fast_size, fast_seconds] = time(
+		  [&](const block_t &block) -> size_t
+		  {
+			  if (output.size() < block.out_size) output.resize(block.out_size);
+			  return lak::ok_or_err(
+			    FastLZ4DecodeInto(lak::span(output).first(block.out_size),
+			                      block.data)
+			      .map_err([](auto &&) -> size_t { return 0; }));
+		  });
+		if (job->cancelled()) return;
+
+		// Check the decoders agree outside of the timed loops.
+		for (const auto &block : blocks)
+		{
+			if (job->cancelled()) return;
+			++job->steps_done;
+			lak::binary_reader reader(block.data);
+			auto expected = lak::decode_lz4_block(reader, block.out_size);
+			if (output.size() < block.out_size) output.resize(block.out_size);
+			auto decoded = FastLZ4DecodeInto(
+			  lak::span(output).first(block.out_size), block.data);
+			if (expected.is_ok() != decoded.is_ok()) ++mismatches;
+			else if (expected.is_ok())
+			{
+				const auto &lak_output = expected.unsafe_unwrap();
+				if (lak_output.size() != decoded.unsafe_unwrap() ||
+				    !std::equal(
+				      lak_output.begin(), lak_output.end(), output.begin()))
+					++mismatches;
+			}
+		}
+
+		if (lak_size != fast_size || mismatches > 0)
+			ERROR("LZ4 decoders disagree: lak ",
+			      lak_size,
+			      " bytes, fast ",
+			      fast_size,
+			      " bytes, ",
+			      mismatches,
+			      " mismatched blocks");
+
+		DEBUG("Decoded ",
+		      blocks.size(),
+		      " blocks (",
+		      compressed_size,
+		      " -> ",
+		      lak_size,
+		      " bytes)");
+		DEBUG("lak: ",
+		      lak_seconds * 1000.0,
+		      "ms (",
+		      (lak_size / 1048576.0) / lak_seconds,
+		      " MiB/s)");
+		DEBUG("fast: ",
+		      fast_seconds * 1000.0,
+		      "ms (",
+		      (fast_size / 1048576.0) / fast_seconds,
+		      " MiB/s)");
 	}
 
 	result_t<data_ref_span_t> StreamDecompress(data_reader_t &strm,
@@ -1813,12 +2733,17 @@ namespace SourceExplorer
 		                        lak::deflate_iterator::header_t::none,
 		                        /* anaconda */ true);
 
+		// The expected size comes straight from the file, don't trust it past
+		// what the input could possibly inflate to.
+		size_t reserved = out_size > 0 ? out_size : buffer.size();
+		reserved =
+		  std::min(reserved, strm.remaining().size() * 1032 + buffer.size());
 		lak::array<byte_t> output;
+		output.reserve(reserved);
 		if (auto err = inflater.read(
 		      [&](lak::span<byte_t> v)
 		      {
-			      output.reserve(output.size() + v.size());
-			      for (const byte_t &b : v) output.push_back(b);
+			      AppendBytes(output, reserved, v);
 			      return true;
 		      });
 		    err.is_ok())
@@ -1826,6 +2751,8 @@ namespace SourceExplorer
 			const auto offset     = strm.position();
 			const auto bytes_read = size_t(inflater.input_consumed());
 			ASSERT_GREATER_OR_EQUAL(bytes_read, 0U);
+			// The inflater read straight out of the source.
+			strm.touch(bytes_read);
 			strm.skip(bytes_read).UNWRAP();
 			return lak::ok_t{make_data_ref_ptr(
 			  strm._source, offset, bytes_read, lak::move(output))};
@@ -1844,12 +2771,24 @@ namespace SourceExplorer
 
 	result_t<data_ref_span_t> Decrypt(data_ref_span_t encrypted,
 	                                  chunk_t ID,
-	                                  encoding_t mode)
+	                                  encoding_t mode,
+	                                  decode_context_t *context,
+	                                  size_t max_size)
 	{
 		FUNCTION_CHECKPOINT();
 
+		if (!context)
+			return lak::err_t{
+			  error(error_type::decrypt_failed, u8"No Decode Context")};
+
 		data_reader_t estrm(encrypted);
 
+		// IDs with the low bit set have the first byte XORed with the ID.
+		const uint8_t id_xor =
+		  (context->mode() != game_mode_t::_284) && ((uint16_t)ID & 0x1) != 0
+		    ? uint8_t(((uint16_t)ID & 0xFF) ^ ((uint16_t)ID >> 0x8))
+		    : 0U;
+
 		if (mode == encoding_t::mode3)
 		{
 			if (encrypted.size() <= 4)
@@ -1860,35 +2799,62 @@ namespace SourceExplorer
 			// size_t dataLen = *reinterpret_cast<const uint32_t*>(&encrypted[0]);
 			TRY(estrm.skip(4));
 
-			auto mem_ptr  = estrm.copy_remaining();
-			auto mem_span = lak::span<byte_t>(mem_ptr->get());
+			const auto enc_span = estrm.read_remaining_ref_span();
 
-			data_reader_t mem_reader(mem_ptr);
+			// Decrypt straight out of the source into a temporary buffer. Unless
+			// the data turns out not to be compressed, this buffer is dropped as
+			// soon as it has been inflated.
+			lak::array<byte_t> decrypted;
 
-			if ((_mode != game_mode_t::_284) && ((uint16_t)ID & 0x1) != 0)
-				(uint8_t &)(mem_span[0]) ^=
-				  ((uint16_t)ID & 0xFF) ^ ((uint16_t)ID >> 0x8);
+			// If only the start of the data is wanted, decrypt and inflate a
+			// prefix of the input, doubling it until it either inflates to
+			// max_size bytes or covers all of the input.
+			size_t prefix_size =
+			  max_size < SIZE_MAX
+			    ? std::min(enc_span.size(), std::max<size_t>(max_size + 4, 0x1000))
+			    : enc_span.size();
 
-			if (DecodeChunk(mem_span))
+			for (;;)
 			{
-				if (mem_reader.remaining().size() <= 4)
+				const bool whole = prefix_size == enc_span.size();
+
+				decrypted.resize(prefix_size);
+				if (!context->decode_chunk(
+				      lak::span<const byte_t>(enc_span).first(prefix_size),
+				      lak::span(decrypted)))
+					return lak::err_t{
+					  error(error_type::decrypt_failed, u8"MODE 3 Decryption Failed")};
+
+				(uint8_t &)(decrypted[0]) ^= id_xor;
+
+				if (decrypted.size() <= 4)
 					return lak::err_t{
 					  error(error_type::decrypt_failed,
 					        u8"MODE 3 Decryption Failed: Decoded Chunk Too Small")};
 				// dataLen = *reinterpret_cast<uint32_t*>(&mem[0]);
 
-				TRY(mem_reader.skip(4));
+				// Try Inflate even if it doesn't need to be, unless the data clearly
+				// isn't a zlib stream. The first prefix always covers at least
+				// max_size bytes, so there's no point decrypting any more of it.
+				const auto payload = lak::span<const byte_t>(decrypted).subspan(4);
+				if (!IsZlibStream(payload, !whole)) break;
 
-				auto rem_span = mem_reader.read_remaining_ref_span();
+				if (auto inflated = InflateRaw(payload, false, false, max_size);
+				    inflated.is_ok() &&
+				    (whole || inflated.unsafe_unwrap().size() >= max_size))
+				{
+					return lak::ok_t{data_ref_span_t(
+					  make_data_ref_ptr(enc_span, lak::move(inflated).unwrap()))};
+				}
 
-				// Try Inflate even if it doesn't need to be
-				return lak::ok_t{lak::ok_or_err(
-				  Inflate(rem_span, false, false)
-				    .map_err([&](auto &&) { return rem_span; })
-				    .if_err([](auto ref_span) { DEBUG("Size: ", ref_span.size()); }))};
+				if (whole) break;
+				prefix_size = std::min(enc_span.size(), prefix_size * 2);
 			}
-			return lak::err_t{
-			  error(error_type::decrypt_failed, u8"MODE 3 Decryption Failed")};
+
+			const size_t size = std::min(decrypted.size() - 4, max_size);
+			DEBUG("Size: ", size);
+			return lak::ok_t{data_ref_span_t(
+			  make_data_ref_ptr(enc_span, lak::move(decrypted)), 4, size)};
 		}
 		else
 		{
@@ -1897,14 +2863,17 @@ namespace SourceExplorer
 				  error(error_type::decrypt_failed,
 				        u8"MODE 2 Decryption Failed: Encrypted Buffer Too Small")};
 
-			auto mem_ptr  = estrm.copy_remaining();
-			auto mem_span = lak::span<byte_t>(mem_ptr->get());
+			// The keystream starts from the beginning of the chunk, so a prefix
+			// can be decrypted on its own.
+			const size_t size =
+			  std::min(encrypted.size(), std::max<size_t>(max_size, 1));
 
-			if ((_mode != game_mode_t::_284) && (uint16_t)ID & 0x1)
-				(uint8_t &)(mem_span[0]) ^=
-				  ((uint16_t)ID & 0xFF) ^ ((uint16_t)ID >> 0x8);
+			lak::array<byte_t> decrypted;
+			decrypted.resize(size);
 
-			if (!DecodeChunk(mem_span))
+			if (!context->decode_chunk(
+			      lak::span<const byte_t>(encrypted).first(size),
+			      lak::span(decrypted)))
 			{
 				if (mode == encoding_t::mode2)
 				{
@@ -1913,7 +2882,10 @@ namespace SourceExplorer
 				}
 			}
 
-			return lak::ok_t{mem_ptr};
+			(uint8_t &)(decrypted[0]) ^= id_xor;
+
+			return lak::ok_t{
+			  data_ref_span_t(make_data_ref_ptr(encrypted, lak::move(decrypted)))};
 		}
 	}
 
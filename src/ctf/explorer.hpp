@@ -22,6 +22,7 @@
 #include "../data_ref.hpp"
 
 #include "common.hpp"
+#include "scheduler.hpp"
 
 #include "chunks/header.hpp"
 
@@ -53,6 +54,7 @@
 #include <assert.h>
 #include <atomic>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <istream>
 #include <iterator>
@@ -106,12 +108,22 @@ namespace SourceExplorer
 
 		header_t game;
 
+		lak::shared_ptr<decode_context_t> decode_context =
+		  lak::shared_ptr<decode_context_t>::make();
+
 		lak::u16string project;
 		lak::u16string title;
 		lak::u16string copyright;
 
 		std::unordered_map<uint32_t, size_t> image_handles;
 		std::unordered_map<uint16_t, size_t> object_handles;
+
+		// Called by the bank readers with each item as soon as it has been read,
+		// so it can be dumped while the rest of the bank is still loading. Only
+		// set these before the bank is loaded.
+		std::function<void(const image::item_t &)> on_image_read;
+		std::function<void(const sound::item_t &)> on_sound_read;
+		std::function<void(const music::item_t &)> on_music_read;
 	};
 
 	struct file_state_t
@@ -170,10 +182,18 @@ namespace SourceExplorer
 		data_ref_span_t buffer;
 	};
 
+	// Memory maps the file if memory_map_files is set, otherwise (or if
+	// mapping fails) reads the whole file into memory.
+	result_t<data_ref_ptr_t> LoadFile(const fs::path &path);
+
 	error_t LoadGame(source_explorer_t &srcexp);
 
 	void GetEncryptionKey(game_t &game_state);
 
+	// Generate the encryption key and decryption table ahead of time rather
+	// than on the first decode.
+	void PrepareDecryption(game_t &game_state);
+
 	result_t<image_section_header_t> ParseImageSectionHeader(
 	  data_reader_t &strm);
 
@@ -304,24 +324,136 @@ namespace SourceExplorer
 	//                            uint8_t col_size,
 	//                            uint8_t bytes = 4);
 
-	result_t<size_t> ReadRLE(data_reader_t &strm,
-	                         lak::image4_t &bitmap,
-	                         graphics_mode_t mode,
-	                         uint16_t padding,
-	                         const lak::color4_t palette[256]);
+	// A width * height block of pixels owned by the caller, for the image
+	// decoders to write into. A lak::image4_t converts to one implicitly.
+	struct image_span_t
+	{
+		lak::span<lak::color4_t> pixels;
+		lak::vec2s_t dimensions;
+
+		image_span_t(lak::span<lak::color4_t> pixels, lak::vec2s_t dimensions)
+		: pixels(pixels), dimensions(dimensions)
+		{
+			ASSERT_EQUAL(pixels.size(), dimensions.x * dimensions.y);
+		}
+
+		image_span_t(lak::image4_t &image)
+		: pixels(image.data(), image.contig_size()), dimensions(image.size())
+		{
+		}
+
+		lak::vec2s_t size() const { return dimensions; }
+		size_t contig_size() const { return pixels.size(); }
+		lak::color4_t *data() const { return pixels.data(); }
+	};
+
+	// How ReadRLE and ReadRGB set the alpha of each pixel as it is decoded.
+	enum struct alpha_mode_t
+	{
+		// Keep the alpha of the decoded colour (e.g. because an alpha mask
+		// will be read after the colour data).
+		decoded,
+		// Every pixel is fully opaque.
+		opaque,
+		// Pixels that match the transparent colour get its alpha, all others
+		// are opaque.
+		transparent,
+	};
 
-	result_t<size_t> ReadRGB(data_reader_t &strm,
-	                         lak::image4_t &bitmap,
-	                         graphics_mode_t mode,
-	                         uint16_t padding,
-	                         const lak::color4_t palette[256]);
+	result_t<size_t> ReadRLE(
+	  data_reader_t &strm,
+	  image_span_t bitmap,
+	  graphics_mode_t mode,
+	  uint16_t padding,
+	  const lak::color4_t palette[256],
+	  alpha_mode_t alpha_mode          = alpha_mode_t::decoded,
+	  const lak::color4_t &transparent = {});
+
+	result_t<size_t> ReadRGB(
+	  data_reader_t &strm,
+	  image_span_t bitmap,
+	  graphics_mode_t mode,
+	  uint16_t padding,
+	  const lak::color4_t palette[256],
+	  alpha_mode_t alpha_mode          = alpha_mode_t::decoded,
+	  const lak::color4_t &transparent = {});
 
 	result_t<size_t> ReadAlpha(data_reader_t &strm,
-	                           lak::image4_t &bitmap,
+	                           image_span_t bitmap,
 	                           uint16_t padding);
 
-	void ReadTransparent(const lak::color4_t &transparent,
-	                     lak::image4_t &bitmap);
+	void ReadTransparent(const lak::color4_t &transparent, image_span_t bitmap);
+
+	// Decodes the same pixel data as ReadRLE/ReadRGB (followed by ReadAlpha if
+	// alpha_mask is set), but accepts it a piece at a time as it is produced,
+	// e.g. straight out of the inflater, rather than from one buffer.
+	struct image_decoder_t
+	{
+		enum struct stage_t
+		{
+			color,
+			alpha,
+			finished,
+		};
+
+		image_span_t bitmap;
+		graphics_mode_t mode;
+		bool rle;
+		uint16_t padding;
+		const lak::color4_t *palette;
+		alpha_mode_t alpha_mode;
+		lak::color4_t transparent;
+		bool alpha_mask;
+		uint16_t alpha_padding;
+
+		stage_t stage = stage_t::color;
+		// Next pixel to decode.
+		size_t pixel  = 0;
+		// Position within the current row, including its padding. In points
+		// for RLE colour data and in bytes otherwise.
+		size_t column = 0;
+		// Points left in the current RLE run, and whether it is a repeat run
+		// still waiting for its colour.
+		size_t run_length = 0;
+		bool run_repeat   = false;
+
+		// Holds a point split between two pieces of data.
+		byte_t carry[4];
+		size_t carry_size = 0;
+
+		image_decoder_t(image_span_t bitmap,
+		                graphics_mode_t mode,
+		                bool rle,
+		                uint16_t padding,
+		                const lak::color4_t palette[256],
+		                alpha_mode_t alpha_mode,
+		                const lak::color4_t &transparent,
+		                bool alpha_mask,
+		                uint16_t alpha_padding);
+
+		// Decodes as much of data as it can. Returns the number of bytes used,
+		// which is less than data.size() only once the image is finished.
+		size_t push(lak::span<const byte_t> data);
+
+		bool finished() const { return stage == stage_t::finished; }
+
+	private:
+		// The fewest bytes the current stage needs to make progress.
+		size_t unit_size() const;
+		// Decodes whole units from data, which must hold at least one. Returns
+		// the number of bytes used.
+		size_t decode(lak::span<const byte_t> data);
+		size_t decode_rgb(lak::span<const byte_t> data);
+		size_t decode_rle(lak::span<const byte_t> data);
+		size_t decode_alpha(lak::span<const byte_t> data);
+		void finish_color();
+	};
+
+	// Inflates compressed straight into decoder a window at a time, stopping
+	// once the image is finished.
+	error_t InflateImage(lak::span<const byte_t> compressed,
+	                     bool skip_header,
+	                     image_decoder_t &decoder);
 
 	texture_t CreateTexture(const lak::image4_t &bitmap,
 	                        const lak::graphics_mode mode);
@@ -343,24 +475,67 @@ namespace SourceExplorer
 
 	result_t<data_ref_span_t> Decode(data_ref_span_t encoded,
 	                                 chunk_t ID,
-	                                 encoding_t mode);
+	                                 encoding_t mode,
+	                                 decode_context_t *context,
+	                                 size_t max_size = SIZE_MAX);
+
+	// A cheap check for whether data that might be zlib compressed is worth
+	// inflating, rather than attempting a full inflate and falling back to
+	// the raw data on failure. partial means data is only the start of the
+	// stream.
+	bool LooksCompressed(lak::span<const byte_t> data, bool partial = false);
+
+	// Inflate into a caller supplied buffer, stopping once it is full.
+	// Returns the number of bytes written.
+	result_t<size_t> InflateInto(lak::span<byte_t> output,
+	                             lak::span<const byte_t> compressed,
+	                             bool skip_header,
+	                             bool anaconda);
+
+	// Inflate into a plain array, stopping early once max_size bytes have
+	// been produced. size_hint is the expected size of the output (e.g. from
+	// data_point_t::expected_size), or 0 if unknown.
+	result_t<lak::array<byte_t>> InflateRaw(lak::span<const byte_t> compressed,
+	                                        bool skip_header,
+	                                        bool anaconda,
+	                                        size_t max_size  = SIZE_MAX,
+	                                        size_t size_hint = 0);
+
+	// Inflates every compressed item in the game's banks with both the lak
+	// and fast inflate engines, logging the throughput of each and any items
+	// they don't produce the same bytes for. Meant to be run as its own job,
+	// stops early if job is cancelled.
+	void BenchmarkInflate(game_t &game, const job_ptr_t &job);
 
 	result_t<data_ref_span_t> Inflate(data_ref_span_t compressed,
 	                                  bool skip_header,
 	                                  bool anaconda,
-	                                  size_t max_size = SIZE_MAX);
+	                                  size_t max_size  = SIZE_MAX,
+	                                  size_t size_hint = 0);
 
 	result_t<data_ref_span_t> LZ4Decode(data_ref_span_t compressed,
 	                                    unsigned int out_size);
 
-	result_t<data_ref_span_t> LZ4DecodeReadSize(data_ref_span_t compressed);
+	// Only decodes as much of the block as is needed to produce max_size
+	// bytes.
+	result_t<data_ref_span_t> LZ4DecodeReadSize(data_ref_span_t compressed,
+	                                            size_t max_size = SIZE_MAX);
+
+	// Decodes every LZ4 compressed (mode4) item in the game's banks with both
+	// lak's and the fast LZ4 decoder, logging the throughput of each. Meant
+	// to be run as its own job, stops early if job is cancelled.
+	void BenchmarkLZ4(game_t &game, const job_ptr_t &job);
 
 	result_t<data_ref_span_t> StreamDecompress(data_reader_t &strm,
 	                                           unsigned int out_size);
 
+	// Only decrypts (and for mode3, inflates) as much of the chunk as is
+	// needed to produce max_size bytes.
 	result_t<data_ref_span_t> Decrypt(data_ref_span_t encrypted,
 	                                  chunk_t ID,
-	                                  encoding_t mode);
+	                                  encoding_t mode,
+	                                  decode_context_t *context,
+	                                  size_t max_size = SIZE_MAX);
 
 	result_t<frame::item_t &> GetFrame(game_t &game, uint16_t handle);
 
@@ -0,0 +1,1030 @@
+#include "fast_inflate.hpp"
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace SourceExplorer
+{
+	namespace
+	{
+		constexpr unsigned max_code_bits      = 15;
+		constexpr unsigned litlen_table_bits  = 10;
+		constexpr unsigned dist_table_bits    = 8;
+		constexpr unsigned codelen_table_bits = 7;
+
+		// Subtables are always sized for the longest possible code, and there
+		// is at most one per symbol.
+		constexpr size_t litlen_table_size =
+		  (size_t(1) << litlen_table_bits) +
+		  288 * (size_t(1) << (max_code_bits - litlen_table_bits));
+		constexpr size_t dist_table_size =
+		  (size_t(1) << dist_table_bits) +
+		  32 * (size_t(1) << (max_code_bits - dist_table_bits));
+
+		constexpr size_t max_match_length = 258;
+
+		// Largest distance a match can reach back.
+		constexpr size_t window_size = 0x8000;
+
+		// Extra bytes allocated past the end of the output so matches can be
+		// copied a word at a time without checking for the end.
+		constexpr size_t copy_slack = 16;
+
+		constexpr uint16_t length_base[29] = {
+		  3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+		  31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+		constexpr uint8_t length_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+		                                      1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+		                                      4, 4, 4, 4, 5, 5, 5, 5, 0};
+		constexpr uint16_t dist_base[30] = {
+		  1,   2,   3,   4,   5,   7,    9,    13,   17,   25,
+		  33,  49,  65,  97,  129, 193,  257,  385,  513,  769,
+		  1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+		constexpr uint8_t dist_extra[30] = {0, 0, 0,  0,  1,  1,  2,  2,  3,  3,
+		                                    4, 4, 5,  5,  6,  6,  7,  7,  8,  8,
+		                                    9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+		constexpr uint8_t codelen_order[19] = {
+		  16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+		// Table entries are packed as:
+		//   [0, 8)   length of the code in bits
+		//   [8, 12)  entry type
+		//   [12, 16) number of extra bits, or the size of the subtable
+		//   [16, 32) literal(s), base length/distance or subtable offset
+		enum entry_type_t : uint32_t
+		{
+			entry_invalid  = 0,
+			entry_literal  = 1,
+			// Two literals, the first in the low byte of the value.
+			entry_literal2 = 2,
+			// A length or distance.
+			entry_base     = 3,
+			entry_end      = 4,
+			entry_subtable = 5,
+		};
+
+		constexpr uint32_t make_entry(uint32_t type,
+		                              uint32_t bits,
+		                              uint32_t extra,
+		                              uint32_t value)
+		{
+			return bits | (type << 8) | (extra << 12) | (value << 16);
+		}
+		constexpr uint32_t entry_bits(uint32_t entry) { return entry & 0xFF; }
+		constexpr uint32_t entry_type(uint32_t entry) { return (entry >> 8) & 0xF; }
+		constexpr uint32_t entry_extra(uint32_t entry)
+		{
+			return (entry >> 12) & 0xF;
+		}
+		constexpr uint32_t entry_value(uint32_t entry) { return entry >> 16; }
+
+		uint32_t litlen_symbol_entry(size_t symbol)
+		{
+			if (symbol < 256)
+				return make_entry(entry_literal, 0, 0, uint32_t(symbol));
+			else if (symbol == 256)
+				return make_entry(entry_end, 0, 0, 0);
+			else if (symbol < 286)
+				return make_entry(entry_base,
+				                  0,
+				                  length_extra[symbol - 257],
+				                  length_base[symbol - 257]);
+			else
+				return make_entry(entry_invalid, 0, 0, 0);
+		}
+
+		uint32_t dist_symbol_entry(size_t symbol)
+		{
+			if (symbol < 30)
+				return make_entry(
+				  entry_base, 0, dist_extra[symbol], dist_base[symbol]);
+			else
+				return make_entry(entry_invalid, 0, 0, 0);
+		}
+
+		uint32_t codelen_symbol_entry(size_t symbol)
+		{
+			return make_entry(entry_literal, 0, 0, uint32_t(symbol));
+		}
+
+		uint32_t reverse_bits(uint32_t code, unsigned length)
+		{
+			uint32_t result = 0;
+			for (unsigned i = 0; i < length; ++i, code >>= 1)
+				result = (result << 1) | (code & 1);
+			return result;
+		}
+
+		// Builds a two level lookup table for the canonical huffman code
+		// described by lengths. Codes longer than table_bits go into subtables
+		// indexed by the bits after the first table_bits bits. Incomplete codes
+		// are allowed, the missing codes decode as invalid entries.
+		bool build_table(uint32_t *table,
+		                 unsigned table_bits,
+		                 const uint8_t *lengths,
+		                 size_t count,
+		                 uint32_t (*symbol_entry)(size_t))
+		{
+			uint16_t length_count[max_code_bits + 1] = {};
+			for (size_t i = 0; i < count; ++i) ++length_count[lengths[i]];
+			length_count[0] = 0;
+
+			int left         = 1;
+			unsigned max_len = 0;
+			for (unsigned len = 1; len <= max_code_bits; ++len)
+			{
+				left = (left << 1) - length_count[len];
+				if (left < 0) return false; // over-subscribed
+				if (length_count[len] > 0) max_len = len;
+			}
+
+			uint32_t next_code[max_code_bits + 1] = {};
+			for (unsigned len = 1, code = 0; len <= max_code_bits; ++len)
+			{
+				code            = (code + length_count[len - 1]) << 1;
+				next_code[len]  = code;
+			}
+
+			const size_t primary_size = size_t(1) << table_bits;
+			const unsigned sub_bits =
+			  max_len > table_bits ? max_len - table_bits : 0;
+			const size_t sub_size = size_t(1) << sub_bits;
+			size_t next_subtable  = primary_size;
+
+			std::fill_n(table, primary_size, make_entry(entry_invalid, 0, 0, 0));
+
+			for (size_t symbol = 0; symbol < count; ++symbol)
+			{
+				const unsigned len = lengths[symbol];
+				if (len == 0) continue;
+
+				// Deflate packs codes starting from the most significant bit.
+				const uint32_t code  = reverse_bits(next_code[len]++, len);
+				const uint32_t entry = symbol_entry(symbol) | len;
+
+				if (len <= table_bits)
+				{
+					for (size_t i = code; i < primary_size; i += size_t(1) << len)
+						table[i] = entry;
+				}
+				else
+				{
+					uint32_t &parent = table[code & (primary_size - 1)];
+					if (entry_type(parent) != entry_subtable)
+					{
+						parent = make_entry(
+						  entry_subtable, table_bits, sub_bits, uint32_t(next_subtable));
+						std::fill_n(table + next_subtable,
+						            sub_size,
+						            make_entry(entry_invalid, 0, 0, 0));
+						next_subtable += sub_size;
+					}
+
+					uint32_t *subtable = table + entry_value(parent);
+					for (size_t i = code >> table_bits; i < sub_size;
+					     i += size_t(1) << (len - table_bits))
+						subtable[i] = entry;
+				}
+			}
+
+			return true;
+		}
+
+		// Merge pairs of literals whose codes both fit in the primary table so
+		// runs of literals decode two per lookup.
+		void pair_literals(uint32_t *table)
+		{
+			constexpr size_t primary_size = size_t(1) << litlen_table_bits;
+
+			uint32_t single[primary_size];
+			std::memcpy(single, table, sizeof(single));
+
+			for (size_t i = 0; i < primary_size; ++i)
+			{
+				const uint32_t first = single[i];
+				if (entry_type(first) != entry_literal) continue;
+
+				// The remaining bits of the index are the start of the next code.
+				const uint32_t second = single[i >> entry_bits(first)];
+				if (entry_type(second) != entry_literal ||
+				    entry_bits(first) + entry_bits(second) > litlen_table_bits)
+					continue;
+
+				table[i] = make_entry(entry_literal2,
+				                      entry_bits(first) + entry_bits(second),
+				                      0,
+				                      entry_value(first) |
+				                        (entry_value(second) << 8));
+			}
+		}
+
+		struct fixed_tables_t
+		{
+			uint32_t litlen[litlen_table_size];
+			uint32_t dist[dist_table_size];
+
+			fixed_tables_t()
+			{
+				uint8_t lengths[288];
+				std::fill_n(lengths + 0, 144, 8);
+				std::fill_n(lengths + 144, 112, 9);
+				std::fill_n(lengths + 256, 24, 7);
+				std::fill_n(lengths + 280, 8, 8);
+				build_table(
+				  litlen, litlen_table_bits, lengths, 288, &litlen_symbol_entry);
+				pair_literals(litlen);
+
+				std::fill_n(lengths, 32, 5);
+				build_table(dist, dist_table_bits, lengths, 32, &dist_symbol_entry);
+			}
+		};
+
+		const fixed_tables_t &fixed_tables()
+		{
+			static const fixed_tables_t tables;
+			return tables;
+		}
+
+		// Storage for the tables of dynamic blocks. Per thread so images can be
+		// decoded in parallel without allocating for every chunk.
+		uint32_t *dynamic_tables()
+		{
+			thread_local lak::array<uint32_t> tables;
+			if (tables.size() < litlen_table_size + dist_table_size)
+				tables.resize(litlen_table_size + dist_table_size);
+			return tables.data();
+		}
+
+		bool valid_zlib_header(const byte_t *header)
+		{
+			const unsigned cmf = uint8_t(header[0]);
+			const unsigned flg = uint8_t(header[1]);
+			// Deflate with at most a 32KiB window, no preset dictionary.
+			return (cmf & 0x0F) == 8 && (cmf >> 4) <= 7 &&
+			       ((cmf << 8) | flg) % 31 == 0 && (flg & 0x20) == 0;
+		}
+
+		uint64_t load_le64(const byte_t *data)
+		{
+			// Compilers turn this into a single load on little endian targets.
+			uint64_t result = 0;
+			for (size_t i = 0; i < 8; ++i) result |= uint64_t(data[i]) << (i * 8);
+			return result;
+		}
+
+		// OUT is either byte_t, or uint16_t when decoding speculatively, where
+		// values past 0xFF refer to bytes of a window that isn't known yet.
+		template<typename OUT>
+		struct inflater_t
+		{
+			using result_t = lak::result<size_t, fast_inflate_error_t>;
+			// true if the output filled up before the end of the block.
+			using block_result_t = lak::result<bool, fast_inflate_error_t>;
+
+			const byte_t *in_begin;
+			const byte_t *in;
+			const byte_t *in_end;
+
+			uint64_t bits      = 0;
+			unsigned bit_count = 0;
+			// Number of zero bytes fed into the bit buffer past the end of the
+			// input.
+			unsigned overrun   = 0;
+
+			OUT *out_begin = nullptr;
+			OUT *out       = nullptr;
+			// End of the writable part of the output.
+			OUT *out_end   = nullptr;
+			// End of the output including any slack.
+			OUT *alloc_end = nullptr;
+			size_t limit   = SIZE_MAX;
+			// If set, the output grows (up to limit) as it fills up.
+			lak::array<OUT> *array = nullptr;
+			// If set, the output is passed to sink as it fills up and all but the
+			// last window of it is discarded.
+			fast_inflate_sink_t sink = nullptr;
+			void *sink_context       = nullptr;
+			// Start of the output not yet passed to sink.
+			OUT *flushed             = nullptr;
+			// Total size of the output already discarded.
+			size_t discarded         = 0;
+			bool sink_stopped        = false;
+
+			// Set once the final block has been decoded or the output is full.
+			bool finished = false;
+
+			inflater_t(lak::span<const byte_t> compressed)
+			: in_begin(compressed.data()),
+			  in(compressed.data()),
+			  in_end(compressed.data() + compressed.size())
+			{
+			}
+
+			void set_output(OUT *begin, size_t size, size_t slack)
+			{
+				out_begin = out = begin;
+				out_end         = begin + size;
+				alloc_end       = out_end + slack;
+			}
+
+			// Make sure the bit buffer holds at least 56 bits. Past the end of the
+			// input it is padded with zeros.
+			void refill()
+			{
+				if (in_end - in >= 8)
+				{
+					bits |= load_le64(in) << bit_count;
+					in += (63 - bit_count) >> 3;
+					bit_count |= 56;
+				}
+				else
+				{
+					for (; bit_count <= 56; bit_count += 8)
+					{
+						if (in < in_end)
+							bits |= uint64_t(*in++) << bit_count;
+						else
+							++overrun;
+					}
+				}
+			}
+
+			// Have we consumed any of the padding?
+			bool overran() const { return size_t(overrun) * 8 > bit_count; }
+
+			// The number of bits of the input consumed so far.
+			size_t bit_position() const
+			{
+				return (size_t(in - in_begin) + overrun) * 8 - bit_count;
+			}
+
+			// Continue decoding from an arbitrary bit of the input.
+			void seek(size_t bit)
+			{
+				in        = in_begin + std::min(bit / 8, size_t(in_end - in_begin));
+				bits      = 0;
+				bit_count = 0;
+				overrun   = 0;
+				finished  = false;
+				refill();
+				consume(unsigned(bit % 8));
+			}
+
+			void consume(unsigned count)
+			{
+				bits >>= count;
+				bit_count -= count;
+			}
+
+			uint32_t take(unsigned count)
+			{
+				const uint32_t result =
+				  uint32_t(bits & ((uint64_t(1) << count) - 1));
+				consume(count);
+				return result;
+			}
+
+			// Pass the output produced since the last flush to sink, then slide
+			// the window back to the start of the output. If sink asks to stop,
+			// the output is marked full so decoding finishes.
+			void flush()
+			{
+				if constexpr (std::is_same_v<OUT, byte_t>)
+				{
+					if (out > flushed &&
+					    !sink(sink_context,
+					          lak::span<const byte_t>(flushed, size_t(out - flushed))))
+					{
+						sink_stopped = true;
+						flushed = out_end = out;
+						return;
+					}
+				}
+
+				const size_t keep = std::min(size_t(out - out_begin), window_size);
+				const size_t drop = size_t(out - out_begin) - keep;
+				if (drop > 0) std::memmove(out_begin, out - keep, keep * sizeof(OUT));
+				discarded += drop;
+				out     = out_begin + keep;
+				flushed = out;
+			}
+
+			void reserve(size_t count)
+			{
+				if (sink)
+				{
+					if (!sink_stopped) flush();
+					return;
+				}
+
+				if (!array) return;
+
+				const size_t used     = size_t(out - out_begin);
+				const size_t capacity = size_t(out_end - out_begin);
+				if (capacity >= limit) return;
+
+				const size_t new_capacity = std::min(
+				  std::max({used + count, capacity * 2, size_t(0x8000)}), limit);
+				array->resize(new_capacity + copy_slack);
+				set_output(array->data(), new_capacity, copy_slack);
+				out = out_begin + used;
+			}
+
+			void copy_match(size_t distance, size_t length)
+			{
+				OUT *dst       = out;
+				const OUT *src = out - distance;
+				OUT *const end = out + length;
+
+				if (distance >= 8 && size_t(alloc_end - end) >= 8)
+				{
+					// Each word is fully written before it is read back.
+					do
+					{
+						std::memcpy(dst, src, 8 * sizeof(OUT));
+						dst += 8;
+						src += 8;
+					} while (dst < end);
+				}
+				else if (distance == 1)
+				{
+					std::fill_n(dst, length, *src);
+				}
+				else
+				{
+					while (dst < end) *dst++ = *src++;
+				}
+
+				out = end;
+			}
+
+			block_result_t stored_block()
+			{
+				// Skip to the next byte boundary and hand the whole bytes left in
+				// the bit buffer back to the input.
+				consume(bit_count & 7);
+				if (overran()) return lak::err_t{fast_inflate_error_t::out_of_data};
+				in -= (bit_count >> 3) - overrun;
+				bits      = 0;
+				bit_count = 0;
+				overrun   = 0;
+
+				if (in_end - in < 4)
+					return lak::err_t{fast_inflate_error_t::out_of_data};
+				const uint16_t len  = uint16_t(uint8_t(in[0]) | (uint8_t(in[1]) << 8));
+				const uint16_t nlen = uint16_t(uint8_t(in[2]) | (uint8_t(in[3]) << 8));
+				in += 4;
+				if (len != uint16_t(~nlen))
+					return lak::err_t{fast_inflate_error_t::invalid_stored_length};
+				if (size_t(in_end - in) < len)
+					return lak::err_t{fast_inflate_error_t::out_of_data};
+
+				if (size_t(out_end - out) < len) reserve(len);
+				const size_t count = std::min(size_t(len), size_t(out_end - out));
+				if constexpr (std::is_same_v<OUT, byte_t>)
+				{
+					if (count > 0) std::memcpy(out, in, count);
+				}
+				else
+				{
+					for (size_t i = 0; i < count; ++i) out[i] = OUT(uint8_t(in[i]));
+				}
+				out += count;
+				in += len;
+
+				return lak::ok_t{count < len};
+			}
+
+			block_result_t dynamic_block(uint32_t *litlen, uint32_t *dist)
+			{
+				refill();
+				const size_t hlit  = take(5) + 257;
+				const size_t hdist = take(5) + 1;
+				const size_t hclen = take(4) + 4;
+				if (hlit > 286 || hdist > 30)
+					return lak::err_t{fast_inflate_error_t::invalid_code_lengths};
+
+				uint8_t codelen_lengths[19] = {};
+				for (size_t i = 0; i < hclen; ++i)
+				{
+					refill();
+					codelen_lengths[codelen_order[i]] = uint8_t(take(3));
+				}
+
+				uint32_t codelen_table[size_t(1) << codelen_table_bits];
+				if (!build_table(codelen_table,
+				                 codelen_table_bits,
+				                 codelen_lengths,
+				                 19,
+				                 &codelen_symbol_entry))
+					return lak::err_t{fast_inflate_error_t::invalid_code_lengths};
+
+				uint8_t lengths[286 + 30];
+				for (size_t i = 0; i < hlit + hdist;)
+				{
+					refill();
+					if (overran()) return lak::err_t{fast_inflate_error_t::out_of_data};
+
+					const uint32_t entry =
+					  codelen_table[bits & ((uint32_t(1) << codelen_table_bits) - 1)];
+					if (entry_type(entry) == entry_invalid)
+						return lak::err_t{fast_inflate_error_t::invalid_code_lengths};
+					consume(entry_bits(entry));
+
+					const uint32_t symbol = entry_value(entry);
+					if (symbol < 16)
+					{
+						lengths[i++] = uint8_t(symbol);
+						continue;
+					}
+
+					uint8_t value = 0;
+					size_t repeat = 0;
+					if (symbol == 16)
+					{
+						if (i == 0)
+							return lak::err_t{fast_inflate_error_t::invalid_code_lengths};
+						value  = lengths[i - 1];
+						repeat = 3 + take(2);
+					}
+					else if (symbol == 17)
+						repeat = 3 + take(3);
+					else
+						repeat = 11 + take(7);
+
+					if (i + repeat > hlit + hdist)
+						return lak::err_t{fast_inflate_error_t::invalid_code_lengths};
+					std::fill_n(lengths + i, repeat, value);
+					i += repeat;
+				}
+
+				if (lengths[256] == 0)
+					return lak::err_t{fast_inflate_error_t::invalid_code_lengths};
+
+				if (!build_table(litlen,
+				                 litlen_table_bits,
+				                 lengths,
+				                 hlit,
+				                 &litlen_symbol_entry) ||
+				    !build_table(dist,
+				                 dist_table_bits,
+				                 lengths + hlit,
+				                 hdist,
+				                 &dist_symbol_entry))
+					return lak::err_t{fast_inflate_error_t::invalid_code_lengths};
+				pair_literals(litlen);
+
+				return huffman_block(litlen, dist);
+			}
+
+			block_result_t huffman_block(const uint32_t *litlen,
+			                             const uint32_t *dist)
+			{
+				constexpr uint64_t litlen_mask = (uint64_t(1) << litlen_table_bits) - 1;
+				constexpr uint64_t dist_mask   = (uint64_t(1) << dist_table_bits) - 1;
+
+				for (;;)
+				{
+					if (size_t(out_end - out) <= max_match_length)
+						reserve(max_match_length + 1);
+
+					// One refill covers the longest length code and distance code
+					// along with their extra bits (15 + 5 + 15 + 13 bits).
+					refill();
+					if (overran()) return lak::err_t{fast_inflate_error_t::out_of_data};
+
+					uint32_t entry = litlen[bits & litlen_mask];
+					if (entry_type(entry) == entry_subtable)
+						entry =
+						  litlen[entry_value(entry) +
+						         ((bits >> litlen_table_bits) &
+						          ((uint64_t(1) << entry_extra(entry)) - 1))];
+					consume(entry_bits(entry));
+
+					switch (entry_type(entry))
+					{
+						case entry_literal2:
+							if (out_end - out < 2)
+							{
+								if (out < out_end) *out++ = OUT(uint8_t(entry_value(entry)));
+								return lak::ok_t{true};
+							}
+							out[0] = OUT(uint8_t(entry_value(entry)));
+							out[1] = OUT(uint8_t(entry_value(entry) >> 8));
+							out += 2;
+							break;
+
+						case entry_literal:
+							if (out == out_end) return lak::ok_t{true};
+							*out++ = OUT(uint8_t(entry_value(entry)));
+							break;
+
+						case entry_base:
+						{
+							const size_t length =
+							  entry_value(entry) + take(entry_extra(entry));
+
+							uint32_t dist_entry = dist[bits & dist_mask];
+							if (entry_type(dist_entry) == entry_subtable)
+								dist_entry =
+								  dist[entry_value(dist_entry) +
+								       ((bits >> dist_table_bits) &
+								        ((uint64_t(1) << entry_extra(dist_entry)) - 1))];
+							if (entry_type(dist_entry) != entry_base)
+								return lak::err_t{fast_inflate_error_t::invalid_symbol};
+							consume(entry_bits(dist_entry));
+
+							const size_t distance =
+							  entry_value(dist_entry) + take(entry_extra(dist_entry));
+							if (distance > size_t(out - out_begin))
+								return lak::err_t{fast_inflate_error_t::invalid_distance};
+
+							if (const size_t available = size_t(out_end - out);
+							    length > available)
+							{
+								copy_match(distance, available);
+								return lak::ok_t{true};
+							}
+							copy_match(distance, length);
+						}
+						break;
+
+						case entry_end:
+							return lak::ok_t{false};
+
+						default:
+							return lak::err_t{fast_inflate_error_t::invalid_symbol};
+					}
+				}
+			}
+
+			lak::result<lak::monostate, fast_inflate_error_t> read_header()
+			{
+				if (in_end - in < 2)
+					return lak::err_t{fast_inflate_error_t::out_of_data};
+				if (!valid_zlib_header(in))
+					return lak::err_t{fast_inflate_error_t::invalid_header};
+				in += 2;
+				return lak::ok_t{};
+			}
+
+			// Decode blocks until either the stream is finished or a block ends
+			// at or past stop_bit.
+			result_t run_blocks(size_t stop_bit = SIZE_MAX)
+			{
+				while (!finished && bit_position() < stop_bit)
+				{
+					refill();
+					const bool final_block = take(1) != 0;
+
+					block_result_t result = lak::ok_t{false};
+					switch (take(2))
+					{
+						case 0:
+							result = stored_block();
+							break;
+
+						case 1:
+							result =
+							  huffman_block(fixed_tables().litlen, fixed_tables().dist);
+							break;
+
+						case 2:
+						{
+							uint32_t *tables = dynamic_tables();
+							result = dynamic_block(tables, tables + litlen_table_size);
+						}
+						break;
+
+						default:
+							return lak::err_t{fast_inflate_error_t::invalid_block_type};
+					}
+
+					if (result.is_err()) return lak::err_t{result.unsafe_unwrap_err()};
+
+					// The output is full, stop early.
+					finished = final_block || result.unsafe_unwrap();
+
+					if (!result.unsafe_unwrap() && overran())
+						return lak::err_t{fast_inflate_error_t::out_of_data};
+				}
+
+				return lak::ok_t{size_t(out - out_begin)};
+			}
+
+			result_t run(bool skip_header)
+			{
+				if (!skip_header)
+					if (auto header = read_header(); header.is_err())
+						return lak::err_t{header.unsafe_unwrap_err()};
+
+				return run_blocks();
+			}
+		};
+	}
+
+	const char *fast_inflate_error_name(fast_inflate_error_t err)
+	{
+		switch (err)
+		{
+			case fast_inflate_error_t::out_of_data:
+				return "Out Of Data";
+			case fast_inflate_error_t::invalid_header:
+				return "Invalid Header";
+			case fast_inflate_error_t::invalid_block_type:
+				return "Invalid Block Type";
+			case fast_inflate_error_t::invalid_stored_length:
+				return "Invalid Stored Length";
+			case fast_inflate_error_t::invalid_code_lengths:
+				return "Invalid Code Lengths";
+			case fast_inflate_error_t::invalid_symbol:
+				return "Invalid Symbol";
+			case fast_inflate_error_t::invalid_distance:
+				return "Invalid Distance";
+			default:
+				return "Unknown Error";
+		}
+	}
+
+	lak::result<size_t, fast_inflate_error_t> FastInflate(
+	  lak::array<byte_t> &output,
+	  lak::span<const byte_t> compressed,
+	  bool skip_header,
+	  size_t max_size,
+	  size_t size_hint)
+	{
+		// size_hint comes straight from the file, so don't trust it any further
+		// than the maximum deflate ratio.
+		size_t capacity = size_hint > 0 ? size_hint : 0x8000;
+		capacity =
+		  std::min({capacity, compressed.size() * 1032 + 0x8000, max_size});
+
+		output.resize(capacity + copy_slack);
+
+		inflater_t<byte_t> inflater(compressed);
+		inflater.array = &output;
+		inflater.limit = max_size;
+		inflater.set_output(output.data(), capacity, copy_slack);
+
+		auto result = inflater.run(skip_header);
+		output.resize(size_t(inflater.out - inflater.out_begin));
+		return result;
+	}
+
+	lak::result<size_t, fast_inflate_error_t> FastInflateInto(
+	  lak::span<byte_t> output,
+	  lak::span<const byte_t> compressed,
+	  bool skip_header)
+	{
+		inflater_t<byte_t> inflater(compressed);
+		inflater.limit = output.size();
+		inflater.set_output(output.data(), output.size(), 0);
+		return inflater.run(skip_header);
+	}
+
+	lak::result<size_t, fast_inflate_error_t> FastInflateStream(
+	  lak::span<const byte_t> compressed,
+	  bool skip_header,
+	  fast_inflate_sink_t sink,
+	  void *sink_context)
+	{
+		// Room for the window plus the largest stored block, so there is always
+		// space for a block after sliding the window back.
+		constexpr size_t capacity = window_size + 0x10000;
+
+		lak::array<byte_t> buffer;
+		buffer.resize(capacity + copy_slack);
+
+		inflater_t<byte_t> inflater(compressed);
+		inflater.sink         = sink;
+		inflater.sink_context = sink_context;
+		inflater.set_output(buffer.data(), capacity, copy_slack);
+		inflater.flushed = inflater.out_begin;
+
+		auto result = inflater.run(skip_header).map(
+		  [&](size_t size) { return inflater.discarded + size; });
+		if (result.is_ok() && !inflater.sink_stopped) inflater.flush();
+		return result;
+	}
+
+	namespace
+	{
+		// Don't split streams into regions smaller than this, there has to be
+		// enough work in each region to make up for searching for its first
+		// block and resolving its window.
+		constexpr size_t min_region_size = 0x100000;
+
+		// How far into a region to look for the start of a block.
+		constexpr size_t max_search_size = 0x40000;
+
+		// The output of decoding a region without knowing the window before
+		// it. Values past 0xFF are window_marker plus the index of a byte in
+		// that window.
+		struct speculative_region_t
+		{
+			static constexpr uint16_t window_marker = 0x100;
+
+			size_t start_bit = SIZE_MAX;
+			size_t end_bit   = SIZE_MAX;
+			bool finished    = false;
+			lak::array<uint16_t> output;
+			size_t size = 0;
+		};
+
+		// Could a dynamic, non final block start at this bit?
+		bool maybe_block_start(lak::span<const byte_t> data, size_t bit)
+		{
+			// BFINAL, BTYPE, HLIT and HDIST all fit in 3 bytes.
+			const size_t byte = bit / 8;
+			if (byte + 4 > data.size()) return false;
+			const uint32_t header = uint32_t(uint8_t(data[byte])) |
+			                        (uint32_t(uint8_t(data[byte + 1])) << 8) |
+			                        (uint32_t(uint8_t(data[byte + 2])) << 16) |
+			                        (uint32_t(uint8_t(data[byte + 3])) << 24);
+			const uint32_t bits = header >> (bit % 8);
+			const uint32_t hlit  = (bits >> 3) & 0x1F;
+			const uint32_t hdist = (bits >> 8) & 0x1F;
+			return (bits & 0x7) == 0x4 && hlit <= 29 && hdist <= 29;
+		}
+
+		// Find the first bit in [begin_bit, end_bit) that a dynamic block
+		// could start at, and decode from it until the first block that ends
+		// at or past stop_bit. Candidates that fail to decode are skipped, so
+		// the region found is almost certainly made of real blocks, but it is
+		// only known to be right once the region before it ends exactly where
+		// it starts.
+		void decode_speculative(speculative_region_t &region,
+		                        lak::span<const byte_t> data,
+		                        size_t begin_bit,
+		                        size_t end_bit,
+		                        size_t stop_bit)
+		{
+			region.output.resize(window_size +
+			                     std::max((stop_bit - begin_bit) / 2, window_size) +
+			                     copy_slack);
+			for (size_t i = 0; i < window_size; ++i)
+				region.output[i] =
+				  uint16_t(speculative_region_t::window_marker + i);
+
+			inflater_t<uint16_t> inflater(data);
+			inflater.array = &region.output;
+
+			for (size_t bit = begin_bit; bit < end_bit; ++bit)
+			{
+				if (!maybe_block_start(data, bit)) continue;
+
+				inflater.set_output(region.output.data(),
+				                    region.output.size() - copy_slack,
+				                    copy_slack);
+				inflater.out = inflater.out_begin + window_size;
+				inflater.seek(bit);
+
+				if (auto result = inflater.run_blocks(stop_bit); result.is_ok())
+				{
+					region.start_bit = bit;
+					region.end_bit   = inflater.bit_position();
+					region.finished  = inflater.finished;
+					region.size      = result.unsafe_unwrap() - window_size;
+					return;
+				}
+			}
+		}
+	}
+
+	lak::result<size_t, fast_inflate_error_t> FastInflateParallel(
+	  lak::array<byte_t> &output,
+	  lak::span<const byte_t> compressed,
+	  bool skip_header,
+	  size_t threads,
+	  size_t size_hint)
+	{
+		if (threads == 0) threads = scheduler().thread_count() + 1;
+		const size_t region_count =
+		  std::min(threads, compressed.size() / min_region_size);
+		if (region_count < 2)
+			return FastInflate(output, compressed, skip_header, SIZE_MAX, size_hint);
+
+		const size_t header_bits = skip_header ? 0 : 16;
+		const size_t total_bits  = compressed.size() * 8;
+		auto region_bit          = [&](size_t index)
+		{
+			return header_bits +
+			       (total_bits - header_bits) / region_count * index;
+		};
+
+		// Every region but the first is decoded speculatively in parallel,
+		// while the first is decoded for real.
+		lak::array<speculative_region_t> regions;
+		regions.resize(region_count);
+
+		size_t capacity = size_hint > 0 ? size_hint : compressed.size() * 4;
+		capacity        = std::min(capacity, compressed.size() * 1032 + 0x8000);
+		output.resize(capacity + copy_slack);
+
+		inflater_t<byte_t> inflater(compressed);
+		inflater.array = &output;
+		inflater.set_output(output.data(), capacity, copy_slack);
+
+		auto decode_region = [&](size_t i)
+		{
+			decode_speculative(
+			  regions[i],
+			  compressed,
+			  region_bit(i),
+			  std::min(region_bit(i) + max_search_size * 8, region_bit(i + 1)),
+			  region_bit(i + 1));
+		};
+
+		auto job = scheduler().submit(
+		  "Parallel inflate",
+		  job_priority_t::high,
+		  true,
+		  [&](const job_ptr_t &job)
+		  {
+			  for (size_t i = 2; i < region_count; ++i)
+				  scheduler().spawn(job,
+				                    [&, i](const job_ptr_t &) { decode_region(i); });
+			  decode_region(1);
+		  });
+
+		lak::result<size_t, fast_inflate_error_t> result = lak::ok_t{size_t(0)};
+		if (!skip_header)
+			if (auto header = inflater.read_header(); header.is_err())
+				result = lak::err_t{header.unsafe_unwrap_err()};
+		if (result.is_ok()) result = inflater.run_blocks(region_bit(1));
+
+		// Only help with this job's regions, this thread may itself be in the
+		// middle of some other job's task.
+		scheduler().wait_until([&] { return job->finished(); }, &*job);
+
+		for (size_t i = 1; i < region_count && result.is_ok(); ++i)
+		{
+			if (inflater.finished) break;
+
+			const auto &region = regions[i];
+			const size_t used  = size_t(inflater.out - inflater.out_begin);
+
+			// The region either didn't find a block or found the wrong one, or
+			// it refers back to before the start of the stream.
+			if (region.start_bit != inflater.bit_position() || used < window_size)
+			{
+				result = inflater.run_blocks(region_bit(i + 1));
+				continue;
+			}
+
+			// Resolve the region against the real window.
+			if (used + region.size + copy_slack > output.size())
+				output.resize(
+				  std::max(used + region.size, (output.size() - copy_slack) * 2) +
+				  copy_slack);
+			const byte_t *window = output.data() + used - window_size;
+			byte_t *out          = output.data() + used;
+			const uint16_t *in   = region.output.data() + window_size;
+			for (size_t j = 0; j < region.size; ++j)
+				out[j] =
+				  in[j] < speculative_region_t::window_marker
+				    ? byte_t(in[j])
+				    : window[in[j] - speculative_region_t::window_marker];
+
+			inflater.set_output(
+			  output.data(), output.size() - copy_slack, copy_slack);
+			inflater.out = inflater.out_begin + used + region.size;
+			inflater.seek(region.end_bit);
+			inflater.finished = region.finished;
+		}
+
+		// The last region may have stopped on a block boundary before the
+		// end of the stream.
+		if (result.is_ok() && !inflater.finished) result = inflater.run_blocks();
+
+		output.resize(size_t(inflater.out - inflater.out_begin));
+		return result;
+	}
+
+	bool IsZlibStream(lak::span<const byte_t> data, bool partial)
+	{
+		if (data.size() < 2 || !valid_zlib_header(data.data())) return false;
+
+		// The first block header, BTYPE 3 is reserved.
+		if (data.size() < 3) return partial;
+		if (((uint8_t(data[2]) >> 1) & 0x3) == 0x3) return false;
+
+		// Trial decode the start of the stream. Almost any corruption (or data
+		// that was never compressed) shows up within the first few hundred
+		// bytes of output.
+		byte_t trial[0x100];
+		inflater_t<byte_t> inflater(data);
+		inflater.limit = sizeof(trial);
+		inflater.set_output(trial, sizeof(trial), 0);
+		auto result = inflater.run(false);
+		if (result.is_ok()) return true;
+		if (!partial) return false;
+
+		// Past the end of a truncated stream the decoder reads zeros, which
+		// usually fail as some other error before it notices it's out of data.
+		return result.unsafe_unwrap_err() == fast_inflate_error_t::out_of_data ||
+		       inflater.overrun > 0;
+	}
+}
@@ -0,0 +1,106 @@
+#ifndef SRCEXP_CTF_FAST_INFLATE_HPP
+#define SRCEXP_CTF_FAST_INFLATE_HPP
+
+#include <lak/array.hpp>
+#include <lak/result.hpp>
+#include <lak/span.hpp>
+#include <lak/stdint.hpp>
+
+#include <stdint.h>
+#include <type_traits>
+
+namespace SourceExplorer
+{
+	enum struct fast_inflate_error_t
+	{
+		out_of_data,
+		invalid_header,
+		invalid_block_type,
+		invalid_stored_length,
+		invalid_code_lengths,
+		invalid_symbol,
+		invalid_distance,
+	};
+
+	const char *fast_inflate_error_name(fast_inflate_error_t err);
+
+	// A table driven deflate decoder, an alternative to lak::deflate_iterator
+	// for the non-anaconda streams that make up the bulk of most games.
+	//
+	// Codes are looked up from a 64 bit bit buffer through two level tables,
+	// pairs of short literal codes decode in a single lookup and matches are
+	// copied a word at a time where they don't overlap.
+	//
+	// Like lak::deflate_iterator, decoding stops without error once the
+	// output is full, and the zlib checksum is not verified.
+
+	// Inflate into output, replacing its contents. Decoding stops once
+	// max_size bytes have been produced. size_hint is the expected size of
+	// the output, or 0 if unknown. Returns the number of bytes produced.
+	lak::result<size_t, fast_inflate_error_t> FastInflate(
+	  lak::array<byte_t> &output,
+	  lak::span<const byte_t> compressed,
+	  bool skip_header,
+	  size_t max_size  = SIZE_MAX,
+	  size_t size_hint = 0);
+
+	// Inflate one large stream split into threads regions (0 for one per
+	// scheduler worker, plus the calling thread), decoded on the scheduler.
+	//
+	// The stream is split into regions, each decoded in parallel starting
+	// from the first bit that looks like the start of a dynamic block, with
+	// back references before that point left as references into an unknown
+	// window. Once the region before it has been decoded for real, a region
+	// is accepted only if it started exactly where that one ended, and its
+	// window references are filled in. Regions that guessed wrong are
+	// decoded serially, so the output is always the same as FastInflate's.
+	//
+	// Streams too small to split are inflated serially.
+	lak::result<size_t, fast_inflate_error_t> FastInflateParallel(
+	  lak::array<byte_t> &output,
+	  lak::span<const byte_t> compressed,
+	  bool skip_header,
+	  size_t threads   = 0,
+	  size_t size_hint = 0);
+
+	// Receives inflated data a piece at a time, returns false to stop
+	// decoding early.
+	using fast_inflate_sink_t = bool (*)(void *context,
+	                                     lak::span<const byte_t> output);
+
+	// Inflate without ever holding more than a window and a block or so of
+	// the output, passing it to sink as it is produced. Returns the number of
+	// bytes produced.
+	lak::result<size_t, fast_inflate_error_t> FastInflateStream(
+	  lak::span<const byte_t> compressed,
+	  bool skip_header,
+	  fast_inflate_sink_t sink,
+	  void *sink_context);
+
+	template<typename SINK>
+	lak::result<size_t, fast_inflate_error_t> FastInflateStream(
+	  lak::span<const byte_t> compressed, bool skip_header, SINK &&sink)
+	{
+		using sink_t = std::remove_reference_t<SINK>;
+		return FastInflateStream(
+		  compressed,
+		  skip_header,
+		  [](void *context, lak::span<const byte_t> output) -> bool
+		  { return (*static_cast<sink_t *>(context))(output); },
+		  const_cast<void *>(static_cast<const void *>(&sink)));
+	}
+
+	// Inflate into a caller supplied buffer, stopping once it is full.
+	// Returns the number of bytes written.
+	lak::result<size_t, fast_inflate_error_t> FastInflateInto(
+	  lak::span<byte_t> output,
+	  lak::span<const byte_t> compressed,
+	  bool skip_header);
+
+	// A cheap check for whether data is (the start of, if partial) a zlib
+	// stream: checks the header and first block type, then decodes at most a
+	// few hundred bytes.
+	bool IsZlibStream(lak::span<const byte_t> data, bool partial = false);
+}
+
+#endif
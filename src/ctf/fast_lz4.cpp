@@ -0,0 +1,134 @@
+#include "fast_lz4.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace SourceExplorer
+{
+	const char *fast_lz4_error_name(fast_lz4_error_t err)
+	{
+		switch (err)
+		{
+			case fast_lz4_error_t::out_of_data:
+				return "Out Of Data";
+			case fast_lz4_error_t::invalid_offset:
+				return "Invalid Offset";
+			default:
+				return "Unknown Error";
+		}
+	}
+
+	namespace
+	{
+		// The wide copies below may read and write up to this many bytes past
+		// the end of what they were asked to copy.
+		constexpr size_t wild_copy_slack = 16;
+
+		// Copies at least count bytes from src to dst, CHUNK bytes at a time.
+		// src and dst must be at least CHUNK bytes apart.
+		template<size_t CHUNK>
+		inline void wild_copy(byte_t *dst, const byte_t *src, size_t count)
+		{
+			byte_t *const end = dst + count;
+			do
+			{
+				std::memcpy(dst, src, CHUNK);
+				dst += CHUNK;
+				src += CHUNK;
+			} while (dst < end);
+		}
+	}
+
+	lak::result<size_t, fast_lz4_error_t> FastLZ4DecodeInto(
+	  lak::span<byte_t> output, lak::span<const byte_t> compressed)
+	{
+		const byte_t *in           = compressed.data();
+		const byte_t *const in_end = in + compressed.size();
+		byte_t *out                = output.data();
+		byte_t *const out_begin    = out;
+		byte_t *const out_end      = out + output.size();
+
+		// Lengths of 15 continue into the following bytes.
+		auto read_length = [&](size_t &length) -> bool
+		{
+			if (length != 15) return true;
+			for (;;)
+			{
+				if (in == in_end) return false;
+				const uint8_t b = uint8_t(*in++);
+				length += b;
+				if (b != 255) return true;
+			}
+		};
+
+		while (in < in_end && out < out_end)
+		{
+			const uint8_t token = uint8_t(*in++);
+
+			size_t literals = token >> 4;
+			if (!read_length(literals) || size_t(in_end - in) < literals)
+				return lak::err_t{fast_lz4_error_t::out_of_data};
+
+			if (size_t(in_end - in) >= literals + wild_copy_slack &&
+			    size_t(out_end - out) >= literals + wild_copy_slack)
+			{
+				wild_copy<16>(out, in, literals);
+				out += literals;
+			}
+			else
+			{
+				// Safe tail, this is either the last sequence or the output is
+				// nearly full.
+				const size_t literal_count =
+				  std::min(literals, size_t(out_end - out));
+				if (literal_count > 0) std::memcpy(out, in, literal_count);
+				out += literal_count;
+			}
+			in += literals;
+
+			// The last sequence is only literals.
+			if (in == in_end || out == out_end) break;
+
+			if (in_end - in < 2) return lak::err_t{fast_lz4_error_t::out_of_data};
+			const size_t offset =
+			  size_t(uint8_t(in[0])) | (size_t(uint8_t(in[1])) << 8);
+			in += 2;
+			if (offset == 0 || offset > size_t(out - out_begin))
+				return lak::err_t{fast_lz4_error_t::invalid_offset};
+
+			size_t match_length = token & 0xF;
+			if (!read_length(match_length))
+				return lak::err_t{fast_lz4_error_t::out_of_data};
+			match_length += 4;
+
+			// Matches may overlap their own output, wide copies are only used
+			// where each chunk is read before it's written.
+			const byte_t *match = out - offset;
+			if (size_t(out_end - out) >= match_length + wild_copy_slack &&
+			    offset >= 8)
+			{
+				if (offset >= 16)
+					wild_copy<16>(out, match, match_length);
+				else
+					wild_copy<8>(out, match, match_length);
+				out += match_length;
+			}
+			else if (offset == 1)
+			{
+				const size_t match_count =
+				  std::min(match_length, size_t(out_end - out));
+				std::memset(out, uint8_t(*match), match_count);
+				out += match_count;
+			}
+			else
+			{
+				const size_t match_count =
+				  std::min(match_length, size_t(out_end - out));
+				for (size_t i = 0; i < match_count; ++i) out[i] = match[i];
+				out += match_count;
+			}
+		}
+
+		return lak::ok_t{size_t(out - out_begin)};
+	}
+}
@@ -0,0 +1,31 @@
+#ifndef SRCEXP_CTF_FAST_LZ4_HPP
+#define SRCEXP_CTF_FAST_LZ4_HPP
+
+#include <lak/result.hpp>
+#include <lak/span.hpp>
+#include <lak/stdint.hpp>
+
+#include <stdint.h>
+
+namespace SourceExplorer
+{
+	enum struct fast_lz4_error_t
+	{
+		out_of_data,
+		invalid_offset,
+	};
+
+	const char *fast_lz4_error_name(fast_lz4_error_t err);
+
+	// Decode an LZ4 block into a caller supplied buffer, stopping once it is
+	// full, so a prefix of the block costs only as much as the prefix.
+	// Returns the number of bytes written.
+	//
+	// Away from the ends of the buffers, literals and matches are copied 8 or
+	// 16 bytes at a time, which may scribble over the output past the
+	// returned size. Near the ends it falls back to exact copies.
+	lak::result<size_t, fast_lz4_error_t> FastLZ4DecodeInto(
+	  lak::span<byte_t> output, lak::span<const byte_t> compressed);
+}
+
+#endif
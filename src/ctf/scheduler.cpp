@@ -0,0 +1,275 @@
+#include "scheduler.hpp"
+
+#include <lak/debug.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace SourceExplorer
+{
+	// Which scheduler and queue the current thread belongs to, so tasks spawned
+	// from a worker land on that worker's own deque.
+	thread_local const scheduler_t *this_scheduler = nullptr;
+	thread_local size_t this_queue                 = 0;
+	// The job whose task is currently running on this thread.
+	thread_local const job_t *this_job = nullptr;
+
+	scheduler_t::scheduler_t(size_t thread_count)
+	{
+		thread_count = std::max<size_t>(thread_count, 1U);
+
+		_queues.reserve(thread_count + 1);
+		for (size_t i = 0; i < thread_count + 1; ++i)
+			_queues.push_back(lak::unique_ptr<queue_t>::make());
+
+		_threads.reserve(thread_count);
+		for (size_t i = 0; i < thread_count; ++i)
+			_threads.emplace_back([this, i] { worker(i); });
+	}
+
+	scheduler_t::~scheduler_t()
+	{
+		{
+			std::lock_guard lock(_sleep_mutex);
+			_stopping = true;
+		}
+		_sleep.notify_all();
+		for (auto &thread : _threads) thread.join();
+	}
+
+	job_ptr_t scheduler_t::submit(lak::astring name,
+	                              job_priority_t priority,
+	                              bool parallel,
+	                              job_task_t task,
+	                              lak::span<const job_ptr_t> after)
+	{
+		auto job         = job_ptr_t::make();
+		job->name        = lak::move(name);
+		job->priority    = priority;
+		job->parallel    = parallel;
+		job->_first_task = lak::move(task);
+		job->_waiting    = after.size() + 1;
+		// The first task counts as pending from now on, so the job doesn't look
+		// finished while it is still waiting.
+		++job->_pending;
+
+		for (const auto &other : after)
+		{
+			std::unique_lock lock(other->_mutex);
+			if (other->_done)
+			{
+				lock.unlock();
+				if (other->cancelled()) job->cancel();
+				release(job);
+			}
+			else
+			{
+				other->_dependents.push_back(job);
+			}
+		}
+
+		// The first task always goes through the queues, even for serial jobs,
+		// so submit never blocks the caller.
+		release(job);
+		return job;
+	}
+
+	void scheduler_t::spawn(const job_ptr_t &job, job_task_t task)
+	{
+		ASSERT(!job->finished());
+		++job->_pending;
+		task_t t{.job = job, .func = lak::move(task)};
+		if (job->parallel)
+			push(lak::move(t));
+		else
+			run(t);
+	}
+
+	void scheduler_t::hold(const job_ptr_t &job)
+	{
+		ASSERT(!job->finished());
+		++job->_pending;
+	}
+
+	void scheduler_t::unhold(const job_ptr_t &job)
+	{
+		if (--job->_pending == 0) finish(job);
+	}
+
+	void scheduler_t::wait(const job_t &job)
+	{
+		ASSERT(this_job != &job);
+
+		wait_until([&] { return job.finished(); });
+	}
+
+	void scheduler_t::wait_until(const std::function<bool()> &done,
+	                             const job_t *only)
+	{
+		task_t task;
+		while (!done())
+		{
+			// Other jobs' tasks don't count when only is set, so sleep until
+			// something new has been queued rather than while anything is.
+			const size_t seen = _wakeups;
+			if (try_pop(task, only))
+			{
+				run(task);
+				continue;
+			}
+
+			std::unique_lock lock(_sleep_mutex);
+			_sleep.wait(lock, [&] { return _wakeups != seen || done(); });
+		}
+	}
+
+	void scheduler_t::notify()
+	{
+		{
+			std::lock_guard lock(_sleep_mutex);
+			++_wakeups;
+		}
+		_sleep.notify_all();
+	}
+
+	void scheduler_t::release(const job_ptr_t &job)
+	{
+		if (--job->_waiting == 0)
+			push(task_t{.job = job, .func = lak::move(job->_first_task)});
+	}
+
+	void scheduler_t::finish(const job_ptr_t &job)
+	{
+		lak::array<job_ptr_t> dependents;
+		{
+			std::lock_guard lock(job->_mutex);
+			job->_done = true;
+			dependents = lak::move(job->_dependents);
+		}
+
+		for (const auto &dependent : dependents)
+		{
+			if (job->cancelled()) dependent->cancel();
+			release(dependent);
+		}
+
+		// Anyone waiting on this job may be asleep.
+		notify();
+	}
+
+	void scheduler_t::push(task_t task)
+	{
+		const size_t index = this_scheduler == this ? this_queue : 0;
+		const size_t p     = static_cast<size_t>(task.job->priority);
+		// Count the task before it is visible so _queued can never underflow,
+		// a sleeper that wakes early just retries until the push lands.
+		{
+			std::lock_guard lock(_sleep_mutex);
+			++_queued;
+			++_wakeups;
+		}
+		{
+			std::lock_guard lock(_queues[index]->mutex);
+			_queues[index]->tasks[p].push_back(lak::move(task));
+		}
+		// Waiters may only want tasks from one job, so wake everyone rather
+		// than risk the one woken thread not taking it.
+		_sleep.notify_all();
+	}
+
+	bool scheduler_t::try_pop(task_t &task, const job_t *only)
+	{
+		if (_queued == 0) return false;
+
+		const size_t self = this_scheduler == this ? this_queue : 0;
+
+		auto take = [&](queue_t &queue, size_t p, bool newest) -> bool
+		{
+			std::lock_guard lock(queue.mutex);
+			auto &tasks = queue.tasks[p];
+			if (tasks.empty()) return false;
+
+			auto it = newest ? tasks.end() - 1 : tasks.begin();
+			if (only)
+			{
+				it = std::find_if(tasks.begin(),
+				                  tasks.end(),
+				                  [&](const task_t &t) { return &*t.job == only; });
+				if (it == tasks.end()) return false;
+			}
+
+			task = lak::move(*it);
+			tasks.erase(it);
+			--_queued;
+			return true;
+		};
+
+		for (size_t p = 0; p < job_priority_count; ++p)
+		{
+			// Our own newest task first, it is the most likely to still be in
+			// cache. The outside queue is only ever drained oldest first.
+			if (take(*_queues[self], p, self != 0)) return true;
+
+			// Then steal the oldest task from everyone else, starting from our
+			// neighbour so the workers don't all hammer the same queue.
+			for (size_t i = 1; i < _queues.size(); ++i)
+				if (take(*_queues[(self + i) % _queues.size()], p, false)) return true;
+		}
+
+		return false;
+	}
+
+	void scheduler_t::run(task_t &task)
+	{
+		job_t &job = *task.job;
+
+		if (!job.cancelled())
+		{
+			const job_t *outer_job = std::exchange(this_job, &job);
+			try
+			{
+				task.func(task.job);
+			}
+			catch (const std::exception &e)
+			{
+				ERROR("Uncaught Exception in job '", job.name, "': ", e.what());
+			}
+			catch (...)
+			{
+				ERROR("Uncaught Exception in job '", job.name, "'");
+			}
+			this_job = outer_job;
+		}
+
+		if (--job._pending == 0) finish(task.job);
+
+		task = task_t{};
+	}
+
+	void scheduler_t::worker(size_t index)
+	{
+		this_scheduler = this;
+		this_queue     = index + 1;
+
+		task_t task;
+		for (;;)
+		{
+			if (try_pop(task))
+			{
+				run(task);
+				continue;
+			}
+
+			std::unique_lock lock(_sleep_mutex);
+			if (_stopping && _queued == 0) break;
+			_sleep.wait(lock, [&] { return _queued > 0 || _stopping; });
+		}
+	}
+
+	scheduler_t &scheduler()
+	{
+		static scheduler_t result(std::thread::hardware_concurrency());
+		return result;
+	}
+}
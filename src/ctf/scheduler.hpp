@@ -0,0 +1,157 @@
+#ifndef SRCEXP_CTF_SCHEDULER_HPP
+#define SRCEXP_CTF_SCHEDULER_HPP
+
+#include <lak/array.hpp>
+#include <lak/memory.hpp>
+#include <lak/span.hpp>
+#include <lak/string.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace SourceExplorer
+{
+	enum struct job_priority_t : uint8_t
+	{
+		high   = 0,
+		normal = 1,
+		low    = 2,
+	};
+
+	static constexpr size_t job_priority_count = 3;
+
+	struct scheduler_t;
+
+	// A group of tasks that are prioritised, tracked and cancelled together.
+	struct job_t
+	{
+		lak::astring name;
+		job_priority_t priority = job_priority_t::normal;
+		// When false every task spawned into this job runs immediately on the
+		// spawning thread, one after the other.
+		bool parallel = true;
+
+		// Tasks add the steps they expect to take and mark them done as they go,
+		// whoever is displaying the job reads progress().
+		std::atomic_size_t steps      = 0;
+		std::atomic_size_t steps_done = 0;
+
+		float progress() const
+		{
+			const size_t total = steps;
+			return total ? (float)((double)steps_done / (double)total) : 0.0f;
+		}
+
+		// Tasks that have not started yet are dropped, running tasks are
+		// expected to check cancelled() and return early.
+		void cancel() { _cancelled = true; }
+		bool cancelled() const { return _cancelled; }
+
+		// True once every task spawned into this job has returned.
+		bool finished() const { return _pending == 0; }
+
+	private:
+		friend scheduler_t;
+		std::atomic_bool _cancelled = false;
+		std::atomic_size_t _pending = 0;
+
+		// Jobs this one is still waiting on, plus one while it is being
+		// submitted. The first task is held here until that reaches zero.
+		std::atomic_size_t _waiting = 0;
+		std::function<void(const lak::shared_ptr<job_t> &)> _first_task;
+
+		std::mutex _mutex;
+		// Guarded by _mutex.
+		bool _done = false;
+		lak::array<lak::shared_ptr<job_t>> _dependents;
+	};
+
+	using job_ptr_t  = lak::shared_ptr<job_t>;
+	using job_task_t = std::function<void(const job_ptr_t &)>;
+
+	// A fixed pool of workers that each own a deque of tasks per priority.
+	// Workers pop their own newest task first and steal the oldest task from
+	// the other workers when they run dry, higher priorities always first.
+	struct scheduler_t
+	{
+		explicit scheduler_t(size_t thread_count);
+		~scheduler_t();
+
+		scheduler_t(const scheduler_t &)            = delete;
+		scheduler_t &operator=(const scheduler_t &) = delete;
+
+		size_t thread_count() const { return _threads.size(); }
+
+		// Creates a job and queues task as its first task once every job in
+		// after has finished. If any of those were cancelled then so is this.
+		job_ptr_t submit(lak::astring name,
+		                 job_priority_t priority,
+		                 bool parallel,
+		                 job_task_t task,
+		                 lak::span<const job_ptr_t> after = {});
+
+		// Queues another task for a job that has not finished yet, usually
+		// from inside one of its own tasks.
+		void spawn(const job_ptr_t &job, job_task_t task);
+
+		// Keeps job from finishing until the matching unhold, for work the job
+		// has handed off somewhere the scheduler can't see (e.g. a file writer).
+		void hold(const job_ptr_t &job);
+		void unhold(const job_ptr_t &job);
+
+		// Blocks until job has finished, running queued tasks on the calling
+		// thread in the mean time. Must not be called from job's own tasks, they
+		// would be waiting on themselves.
+		void wait(const job_t &job);
+
+		// Blocks until done returns true, running queued tasks (only those of
+		// job only, if set) on the calling thread in the mean time. Whatever
+		// makes done true must call notify.
+		void wait_until(const std::function<bool()> &done,
+		                const job_t *only = nullptr);
+
+		// Wakes everything blocked in wait and wait_until to check again.
+		void notify();
+
+	private:
+		struct task_t
+		{
+			job_ptr_t job;
+			job_task_t func;
+		};
+
+		struct queue_t
+		{
+			std::mutex mutex;
+			std::deque<task_t> tasks[job_priority_count];
+		};
+
+		void push(task_t task);
+		bool try_pop(task_t &task, const job_t *only = nullptr);
+		void run(task_t &task);
+		void release(const job_ptr_t &job);
+		void finish(const job_ptr_t &job);
+		void worker(size_t index);
+
+		// _queues[0] is fed by threads outside the pool, _queues[i + 1] is
+		// owned by worker i.
+		lak::array<lak::unique_ptr<queue_t>> _queues;
+		lak::array<std::thread> _threads;
+
+		std::mutex _sleep_mutex;
+		std::condition_variable _sleep;
+		std::atomic_size_t _queued  = 0;
+		std::atomic_size_t _wakeups = 0;
+		bool _stopping              = false;
+	};
+
+	// The scheduler shared by the loader and every dump, sized to the hardware
+	// and started the first time this is called.
+	scheduler_t &scheduler();
+}
+
+#endif
@@ -0,0 +1,88 @@
+#include "../color_kernels.hpp"
+#include "test_utils.hpp"
+
+#include <lak/array.hpp>
+#include <lak/debug.hpp>
+#include <lak/test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+BEGIN_TEST(color_kernels)
+{
+	using namespace SourceExplorer;
+
+	// Enough for a 1024x1024 image in any format, over an odd number of pixels
+	// so the kernels' tails are exercised too.
+	const size_t count = 0x100000 - 3;
+	test_random_t random(0x5E);
+
+	lak::array<byte_t> input(count * 4);
+	for (auto &b : input) b = byte_t(random());
+	lak::array<byte_t> palette(256 * 4);
+	for (auto &b : palette) b = byte_t(random());
+
+	lak::array<byte_t> expected(count * 4);
+	lak::array<byte_t> output(count * 4);
+
+	const color_kernels_t &scalar = scalar_color_kernels();
+
+	int failures = 0;
+	for (const color_kernels_t *kernels : supported_color_kernels())
+	{
+		double seconds = 0.0;
+		size_t bytes   = 0;
+
+		auto check = [&](const char *format, auto scalar_kernel, auto kernel)
+		{
+			// Both start from the same colours so the alpha mask kernel has
+			// something to mask.
+			std::copy(input.begin(), input.end(), expected.begin());
+			std::copy(input.begin(), input.end(), output.begin());
+			scalar_kernel(expected.data());
+			const auto start = std::chrono::steady_clock::now();
+			kernel(output.data());
+			const auto end = std::chrono::steady_clock::now();
+			seconds += std::chrono::duration<double>(end - start).count();
+			bytes += output.size();
+			if (!std::equal(expected.begin(), expected.end(), output.begin()))
+			{
+				TEST_FAILED(
+				  failures, kernels->name, " ", format, " kernel differs from scalar");
+			}
+		};
+
+		const std::pair<const char *, color_kernel_t color_kernels_t::*>
+		  packed_kernels[] = {
+		    {"from_24bit_bgr", &color_kernels_t::from_24bit_bgr},
+		    {"from_24bit_rgb", &color_kernels_t::from_24bit_rgb},
+		    {"from_32bit_bgra", &color_kernels_t::from_32bit_bgra},
+		    {"from_32bit_bgr", &color_kernels_t::from_32bit_bgr},
+		    {"from_15bit_rgb", &color_kernels_t::from_15bit_rgb},
+		    {"from_16bit_rgb", &color_kernels_t::from_16bit_rgb},
+		    {"mask_from_8bit_a", &color_kernels_t::mask_from_8bit_a},
+		  };
+		for (const auto &[format, kernel] : packed_kernels)
+			check(
+			  format,
+			  [&](byte_t *out) { (scalar.*kernel)(out, input.data(), count); },
+			  [&](byte_t *out) { (kernels->*kernel)(out, input.data(), count); });
+		check(
+		  "from_8bit_i",
+		  [&](byte_t *out)
+		  { scalar.from_8bit_i(out, input.data(), palette.data(), count); },
+		  [&](byte_t *out)
+		  { kernels->from_8bit_i(out, input.data(), palette.data(), count); });
+
+		DEBUG(kernels->name,
+		      ": ",
+		      seconds * 1000.0,
+		      "ms (",
+		      (bytes / 1048576.0) / seconds,
+		      " MiB/s of RGBA)");
+	}
+
+	return failures;
+}
+END_TEST()
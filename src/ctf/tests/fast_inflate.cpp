@@ -0,0 +1,396 @@
+#include "../fast_inflate.hpp"
+#include "test_utils.hpp"
+
+#include <lak/compression/deflate.hpp>
+#include <lak/debug.hpp>
+#include <lak/test.hpp>
+
+#include <algorithm>
+
+namespace
+{
+	using namespace SourceExplorer;
+
+	struct bit_writer_t
+	{
+		lak::array<byte_t> data;
+		uint64_t buffer = 0;
+		unsigned count  = 0;
+
+		void put(uint32_t bits, unsigned bit_count)
+		{
+			buffer |= uint64_t(bits) << count;
+			count += bit_count;
+			for (; count >= 8; count -= 8, buffer >>= 8)
+				data.push_back(byte_t(buffer));
+		}
+
+		// Huffman codes are packed starting from their most significant bit.
+		void put_code(uint32_t code, unsigned bit_count)
+		{
+			uint32_t reversed = 0;
+			for (unsigned i = 0; i < bit_count; ++i)
+				reversed |= ((code >> i) & 1) << (bit_count - 1 - i);
+			put(reversed, bit_count);
+		}
+
+		void flush()
+		{
+			if (count > 0) data.push_back(byte_t(buffer));
+			buffer = 0;
+			count  = 0;
+		}
+	};
+
+	template<size_t N>
+	void canonical_codes(const uint8_t (&lengths)[N], uint16_t (&codes)[N])
+	{
+		uint16_t length_count[16] = {};
+		for (uint8_t length : lengths) ++length_count[length];
+		length_count[0] = 0;
+
+		uint16_t next[16] = {};
+		uint16_t code     = 0;
+		for (size_t bits = 1; bits < 16; ++bits)
+			next[bits] = code = uint16_t((code + length_count[bits - 1]) << 1);
+
+		for (size_t i = 0; i < N; ++i)
+			if (lengths[i] > 0) codes[i] = next[lengths[i]]++;
+	}
+
+	// A dynamic block header for the given code lengths, codelen_lengths must
+	// only give lengths to the code lengths used by the other two.
+	void put_dynamic_header(bit_writer_t &writer,
+	                        bool final,
+	                        const uint8_t (&litlen_lengths)[259],
+	                        const uint8_t (&dist_lengths)[30],
+	                        const uint8_t (&codelen_lengths)[19])
+	{
+		static constexpr uint8_t codelen_order[19] = {
+		  16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+		uint16_t codelen_codes[19] = {};
+		canonical_codes(codelen_lengths, codelen_codes);
+
+		writer.put(final ? 1 : 0, 1);
+		writer.put(2, 2);
+		writer.put(259 - 257, 5);
+		writer.put(30 - 1, 5);
+		writer.put(18 - 4, 4);
+		for (size_t i = 0; i < 18; ++i)
+			writer.put(codelen_lengths[codelen_order[i]], 3);
+		for (uint8_t length : litlen_lengths)
+			writer.put_code(codelen_codes[length], codelen_lengths[length]);
+		for (uint8_t length : dist_lengths)
+			writer.put_code(codelen_codes[length], codelen_lengths[length]);
+	}
+
+	// Flushes the last partial byte and appends the zlib trailer.
+	void finish_stream(bit_writer_t &writer, const lak::array<byte_t> &expected)
+	{
+		writer.flush();
+
+		uint32_t a = 1, b = 0;
+		for (byte_t c : expected)
+		{
+			a = (a + uint8_t(c)) % 65521;
+			b = (b + a) % 65521;
+		}
+		const uint32_t adler = (b << 16) | a;
+		for (unsigned shift = 32; shift > 0; shift -= 8)
+			writer.data.push_back(byte_t(adler >> (shift - 8)));
+	}
+
+	// A zlib stream of pseudo random literals and matches, split into dynamic
+	// blocks of about block_size bytes of output each. Every block uses the
+	// same (complete) codes:
+	// - literals 0-253 are 8 bits, 254 and 255, end of block and length 4
+	//   (symbol 258) are 9 bits.
+	// - distance 1 (symbol 0) and 24577+ (symbol 29) are 1 bit each.
+	struct synthetic_stream_t
+	{
+		lak::array<byte_t> compressed;
+		lak::array<byte_t> expected;
+	};
+
+	synthetic_stream_t make_stream(size_t size, size_t block_size, uint64_t seed)
+	{
+		uint8_t litlen_lengths[259] = {};
+		for (size_t i = 0; i < 254; ++i) litlen_lengths[i] = 8;
+		for (size_t i : {254, 255, 256, 258}) litlen_lengths[i] = 9;
+
+		uint8_t dist_lengths[30] = {};
+		for (size_t i : {0, 29}) dist_lengths[i] = 1;
+
+		// Code lengths 0, 1, 8 and 9.
+		uint8_t codelen_lengths[19] = {};
+		for (size_t i : {0, 1, 8, 9}) codelen_lengths[i] = 2;
+
+		uint16_t litlen_codes[259] = {};
+		uint16_t dist_codes[30]    = {};
+		canonical_codes(litlen_lengths, litlen_codes);
+		canonical_codes(dist_lengths, dist_codes);
+
+		synthetic_stream_t result;
+		bit_writer_t writer;
+		writer.put(0x78, 8);
+		writer.put(0x9C, 8);
+
+		test_random_t random(seed);
+
+		auto put_literal = [&](uint8_t value)
+		{
+			writer.put_code(litlen_codes[value], litlen_lengths[value]);
+			result.expected.push_back(byte_t(value));
+		};
+
+		auto put_match = [&](size_t distance)
+		{
+			writer.put_code(litlen_codes[258], litlen_lengths[258]);
+			if (distance == 1)
+			{
+				writer.put_code(dist_codes[0], dist_lengths[0]);
+			}
+			else
+			{
+				writer.put_code(dist_codes[29], dist_lengths[29]);
+				writer.put(uint32_t(distance - 24577), 13);
+			}
+			for (size_t i = 0; i < 4; ++i)
+				result.expected.push_back(
+				  result.expected[result.expected.size() - distance]);
+		};
+
+		while (result.expected.size() < size)
+		{
+			const size_t block_end =
+			  std::min(result.expected.size() + block_size, size);
+
+			put_dynamic_header(writer,
+			                   block_end == size,
+			                   litlen_lengths,
+			                   dist_lengths,
+			                   codelen_lengths);
+
+			while (result.expected.size() < block_end)
+			{
+				const uint64_t value = random();
+				const size_t used    = result.expected.size();
+				if ((value & 7) == 0 && used >= 0x8000)
+					put_match(24577 + ((value >> 8) & 0x1FFF));
+				else if ((value & 7) == 1 && used >= 1)
+					put_match(1);
+				else
+					put_literal(uint8_t(value >> 8));
+			}
+
+			writer.put_code(litlen_codes[256], litlen_lengths[256]);
+		}
+
+		finish_stream(writer, result.expected);
+		result.compressed = lak::move(writer.data);
+		return result;
+	}
+
+	// A single block of pseudo random literals, with codes chosen so that the
+	// zeros past the end of a truncated copy decode as a match from further
+	// back than the start of the output:
+	// - length 3 (symbol 257) is 1 bit, literals 0-254 are 9 bits, 255 and end
+	//   of block are 10 bits.
+	// - distance 24577+ (symbol 29) is 1 bit, distances 1 and 2 are 2 bits.
+	lak::array<byte_t> make_literal_stream(size_t size, uint64_t seed)
+	{
+		uint8_t litlen_lengths[259] = {};
+		for (size_t i = 0; i < 255; ++i) litlen_lengths[i] = 9;
+		for (size_t i : {255, 256}) litlen_lengths[i] = 10;
+		litlen_lengths[257] = 1;
+
+		uint8_t dist_lengths[30] = {};
+		for (size_t i : {0, 1}) dist_lengths[i] = 2;
+		dist_lengths[29] = 1;
+
+		// Code lengths 0, 1, 2, 9 and 10.
+		uint8_t codelen_lengths[19] = {};
+		for (size_t i : {0, 9, 10}) codelen_lengths[i] = 2;
+		for (size_t i : {1, 2}) codelen_lengths[i] = 3;
+
+		uint16_t litlen_codes[259] = {};
+		canonical_codes(litlen_lengths, litlen_codes);
+
+		bit_writer_t writer;
+		writer.put(0x78, 8);
+		writer.put(0x9C, 8);
+		put_dynamic_header(
+		  writer, true, litlen_lengths, dist_lengths, codelen_lengths);
+
+		test_random_t random(seed);
+		lak::array<byte_t> expected;
+		for (size_t i = 0; i < size; ++i)
+		{
+			const uint8_t value = uint8_t(random());
+			writer.put_code(litlen_codes[value], litlen_lengths[value]);
+			expected.push_back(byte_t(value));
+		}
+		writer.put_code(litlen_codes[256], litlen_lengths[256]);
+
+		finish_stream(writer, expected);
+		return lak::move(writer.data);
+	}
+
+	bool same_bytes(const lak::array<byte_t> &a, const lak::array<byte_t> &b)
+	{
+		return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+	}
+}
+
+BEGIN_TEST(fast_inflate)
+{
+	int failures = 0;
+	test_random_t seeds(0x9E3779B97F4A7C15);
+	for (const size_t size : {0x10, 0x1000, 0x9000, 0x40000})
+	{
+		const auto stream = make_stream(size, 0x4000, seeds());
+		const lak::span<const byte_t> compressed(stream.compressed);
+
+		lak::array<byte_t> expected;
+		lak::array<byte_t, 0x8000> buffer;
+		auto inflater = lak::deflate_iterator(
+		  compressed, buffer, lak::deflate_iterator::header_t::zlib, false);
+		auto lak_result = inflater.read(
+		  [&](lak::span<byte_t> v)
+		  {
+			  for (const byte_t b : v) expected.push_back(b);
+			  return true;
+		  });
+		if (lak_result.is_err() || !same_bytes(expected, stream.expected))
+		{
+			TEST_FAILED(failures, "lak failed to inflate a ", size, " byte stream");
+			continue;
+		}
+
+		lak::array<byte_t> output;
+		auto result = FastInflate(output, compressed, false);
+		if (result.is_err() || !same_bytes(output, expected))
+		{
+			TEST_FAILED(
+			  failures, "FastInflate differs from lak on a ", size, " byte stream");
+		}
+
+		result = FastInflate(output, compressed.subspan(2), true);
+		if (result.is_err() || !same_bytes(output, expected))
+		{
+			TEST_FAILED(failures,
+			            "FastInflate differs from lak on a ",
+			            size,
+			            " byte stream without its header");
+		}
+
+		const size_t max_size = size / 3;
+		result = FastInflate(output, compressed, false, max_size);
+		if (result.is_err() || output.size() != max_size ||
+		    !std::equal(output.begin(), output.end(), expected.begin()))
+		{
+			TEST_FAILED(failures,
+			            "FastInflate didn't stop after ",
+			            max_size,
+			            " bytes of a ",
+			            size,
+			            " byte stream");
+		}
+	}
+
+	return failures;
+}
+END_TEST()
+
+BEGIN_TEST(fast_inflate_parallel)
+{
+	struct
+	{
+		size_t size;
+		size_t block_size;
+		size_t threads;
+	} cases[] = {
+	  // Plenty of blocks, regions should all be accepted.
+	  {0x600000, 0x10000, 4},
+	  // Blocks longer than the search distance, most regions have to fall back
+	  // to serial.
+	  {0x600000, 0x200000, 4},
+	  // A single block.
+	  {0x300000, 0x300000, 2},
+	  // Too small to split.
+	  {0x10000, 0x1000, 4},
+	};
+
+	int failures = 0;
+	test_random_t seeds(0x2545F4914F6CDD1D);
+	for (const auto &c : cases)
+	{
+		const auto stream = make_stream(c.size, c.block_size, seeds());
+
+		lak::array<byte_t> serial;
+		auto serial_result = FastInflate(serial, stream.compressed, false);
+		if (serial_result.is_err() || !same_bytes(serial, stream.expected))
+		{
+			TEST_FAILED(failures,
+			            "FastInflate failed on a ",
+			            c.size,
+			            " byte stream of ",
+			            c.block_size,
+			            " byte blocks");
+			continue;
+		}
+
+		lak::array<byte_t> parallel;
+		auto parallel_result =
+		  FastInflateParallel(parallel, stream.compressed, false, c.threads);
+		if (parallel_result.is_err() || !same_bytes(parallel, serial))
+		{
+			TEST_FAILED(failures,
+			            "FastInflateParallel differs from FastInflate on a ",
+			            c.size,
+			            " byte stream of ",
+			            c.block_size,
+			            " byte blocks");
+		}
+	}
+
+	return failures;
+}
+END_TEST()
+
+BEGIN_TEST(is_zlib_stream)
+{
+	int failures = 0;
+
+	const auto stream = make_literal_stream(0x100, 0x9E3779B97F4A7C15);
+	const lak::span<const byte_t> compressed(stream);
+
+	if (!IsZlibStream(compressed))
+	{
+		TEST_FAILED(failures, "IsZlibStream rejected a whole stream");
+	}
+
+	// Every prefix of the stream could be the start of it.
+	for (size_t prefix = 2; prefix < compressed.size(); ++prefix)
+	{
+		if (!IsZlibStream(compressed.first(prefix), true))
+		{
+			TEST_FAILED(failures,
+			            "IsZlibStream rejected the first ",
+			            prefix,
+			            " of ",
+			            compressed.size(),
+			            " bytes of a stream");
+		}
+	}
+
+	// Though not without its header.
+	if (IsZlibStream(compressed.subspan(2), true))
+	{
+		TEST_FAILED(failures, "IsZlibStream accepted a stream without its header");
+	}
+
+	return failures;
+}
+END_TEST()
@@ -0,0 +1,142 @@
+#include "../fast_lz4.hpp"
+#include "test_utils.hpp"
+
+#include <lak/binary_reader.hpp>
+#include <lak/compression/lz4.hpp>
+#include <lak/debug.hpp>
+#include <lak/test.hpp>
+
+#include <algorithm>
+
+namespace
+{
+	using namespace SourceExplorer;
+
+	struct synthetic_block_t
+	{
+		lak::array<byte_t> compressed;
+		lak::array<byte_t> expected;
+	};
+
+	// An LZ4 block of about size bytes of pseudo random literals and matches.
+	// Runs of up to max_run bytes, so long runs exercise the 255 extension
+	// bytes and short offsets exercise overlapping matches.
+	synthetic_block_t make_block(size_t size, size_t max_run, uint64_t seed)
+	{
+		synthetic_block_t result;
+		test_random_t random(seed);
+
+		auto put_length = [&](size_t length)
+		{
+			for (; length >= 255; length -= 255)
+				result.compressed.push_back(byte_t(255));
+			result.compressed.push_back(byte_t(length));
+		};
+
+		auto put_sequence = [&](size_t literals, size_t offset, size_t match)
+		{
+			const size_t match_code = match > 0 ? match - 4 : 0;
+			result.compressed.push_back(
+			  byte_t((std::min<size_t>(literals, 15) << 4) |
+			         std::min<size_t>(match_code, 15)));
+			if (literals >= 15) put_length(literals - 15);
+
+			for (size_t i = 0; i < literals; ++i)
+			{
+				const byte_t b = byte_t(random());
+				result.compressed.push_back(b);
+				result.expected.push_back(b);
+			}
+
+			// The last sequence is only literals.
+			if (match == 0) return;
+
+			result.compressed.push_back(byte_t(offset));
+			result.compressed.push_back(byte_t(offset >> 8));
+			if (match_code >= 15) put_length(match_code - 15);
+			for (size_t i = 0; i < match; ++i)
+				result.expected.push_back(
+				  result.expected[result.expected.size() - offset]);
+		};
+
+		// The format requires the last match to start at least 12 bytes before
+		// the end, and the last 5 bytes to be literals.
+		while (result.expected.size() + max_run * 2 + 12 < size)
+		{
+			const size_t literals = (random() % max_run) + 1;
+			const size_t used     = result.expected.size() + literals;
+			const size_t offset   = (random() % std::min<size_t>(used, 0xFFFF)) + 1;
+			put_sequence(literals, offset, (random() % max_run) + 4);
+		}
+		put_sequence(std::max<size_t>(size - result.expected.size(), 12), 0, 0);
+
+		return result;
+	}
+}
+
+BEGIN_TEST(fast_lz4)
+{
+	struct
+	{
+		size_t size;
+		size_t max_run;
+	} cases[] = {
+	  {0x20, 4},
+	  {0x1000, 8},
+	  {0x100000, 16},
+	  {0x100000, 600},
+	};
+
+	int failures = 0;
+	test_random_t seeds(0x2545F4914F6CDD1D);
+	for (const auto &c : cases)
+	{
+		const auto block  = make_block(c.size, c.max_run, seeds());
+		const size_t size = block.expected.size();
+
+		lak::binary_reader reader(block.compressed);
+		auto lak_result = lak::decode_lz4_block(reader, size);
+		if (lak_result.is_err() ||
+		    lak_result.unsafe_unwrap().size() != size ||
+		    !std::equal(block.expected.begin(),
+		                block.expected.end(),
+		                lak_result.unsafe_unwrap().begin()))
+		{
+			TEST_FAILED(failures, "lak failed to decode a ", size, " byte block");
+			continue;
+		}
+
+		lak::array<byte_t> output(size);
+		auto result = FastLZ4DecodeInto(lak::span(output), block.compressed);
+		if (result.is_err() || result.unsafe_unwrap() != size ||
+		    !std::equal(block.expected.begin(),
+		                block.expected.end(),
+		                output.begin()))
+		{
+			TEST_FAILED(failures,
+			            "FastLZ4DecodeInto differs from lak on a ",
+			            size,
+			            " byte block");
+		}
+
+		// Stopping early only produces the start of the block.
+		const size_t prefix = size / 3;
+		result =
+		  FastLZ4DecodeInto(lak::span(output).first(prefix), block.compressed);
+		if (result.is_err() || result.unsafe_unwrap() != prefix ||
+		    !std::equal(output.begin(),
+		                output.begin() + prefix,
+		                block.expected.begin()))
+		{
+			TEST_FAILED(failures,
+			            "FastLZ4DecodeInto didn't stop after ",
+			            prefix,
+			            " bytes of a ",
+			            size,
+			            " byte block");
+		}
+	}
+
+	return failures;
+}
+END_TEST()
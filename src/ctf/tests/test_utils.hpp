@@ -0,0 +1,36 @@
+#ifndef SRCEXP_CTF_TESTS_TEST_UTILS_HPP
+#define SRCEXP_CTF_TESTS_TEST_UTILS_HPP
+
+#include <lak/debug.hpp>
+
+#include <stdint.h>
+
+namespace SourceExplorer
+{
+	// A xorshift64 generator, so the tests build the same inputs on every run
+	// and platform.
+	struct test_random_t
+	{
+		uint64_t state;
+
+		explicit test_random_t(uint64_t seed) : state(seed) {}
+
+		uint64_t operator()()
+		{
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			return state;
+		}
+	};
+}
+
+// Logs why a check failed and counts it in FAILURES, which the test returns.
+#define TEST_FAILED(FAILURES, ...)                                            \
+	do                                                                          \
+	{                                                                           \
+		ERROR(__VA_ARGS__);                                                       \
+		++(FAILURES);                                                             \
+	} while (false)
+
+#endif
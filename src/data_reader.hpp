@@ -14,7 +14,7 @@ namespace SourceExplorer
 		data_ref_ptr_t _source;
 
 		data_reader_t(data_ref_ptr_t src)
-		: lak::binary_reader(src ? lak::span<const byte_t>(src->get())
+		: lak::binary_reader(src ? lak::span<const byte_t>(src->span())
 		                         : lak::span<const byte_t>()),
 		  _source(src)
 		{
@@ -25,10 +25,21 @@ namespace SourceExplorer
 		{
 		}
 
+		// Counts the next count bytes against a memory mapped source's resident
+		// budget. data_ref_span_t does this itself, this is for bytes read
+		// straight through the reader.
+		void touch(size_t count) const
+		{
+			if (!_source || !_source->mapping()) return;
+			_source->mapping()->touch(
+			  size_t(remaining().begin() - _source->data()),
+			  std::min(remaining().size(), count));
+		}
+
 		data_ref_span_t peek_remaining_ref_span(size_t max_size = SIZE_MAX)
 		{
 			ASSERT(_source);
-			const size_t offset = remaining().begin() - _source->_data.data();
+			const size_t offset = remaining().begin() - _source->data();
 			const size_t size   = std::min(remaining().size(), max_size);
 			return data_ref_span_t(_source, offset, size);
 		}
@@ -37,7 +48,7 @@ namespace SourceExplorer
 		{
 			if (!_source) return lak::err_t{};
 			if (size > remaining().size()) return lak::err_t{};
-			const size_t offset = remaining().begin() - _source->_data.data();
+			const size_t offset = remaining().begin() - _source->data();
 			skip(size).UNWRAP();
 			return lak::ok_t{data_ref_span_t(_source, offset, size)};
 		}
@@ -45,7 +56,7 @@ namespace SourceExplorer
 		data_ref_span_t read_remaining_ref_span(size_t max_size = SIZE_MAX)
 		{
 			ASSERT(_source);
-			const size_t offset = remaining().begin() - _source->_data.data();
+			const size_t offset = remaining().begin() - _source->data();
 			const size_t size   = std::min(remaining().size(), max_size);
 			skip(size).UNWRAP();
 			return data_ref_span_t(_source, offset, size);
@@ -65,7 +76,7 @@ namespace SourceExplorer
 		                                      lak::array<byte_t> data)
 		{
 			ASSERT(_source);
-			const size_t offset = remaining().begin() - _source->_data.data();
+			const size_t offset = remaining().begin() - _source->data();
 			const size_t size   = std::min(remaining().size(), max_size);
 			skip(size).UNWRAP();
 			return make_data_ref_ptr(_source, offset, size, lak::move(data));
@@ -1,6 +1,8 @@
 #ifndef SRCEXP_DATA_REF_HPP
 #define SRCEXP_DATA_REF_HPP
 
+#include "mapped_file.hpp"
+
 #include <lak/array.hpp>
 #include <lak/memory.hpp>
 #include <lak/span.hpp>
@@ -9,9 +11,10 @@ namespace SourceExplorer
 {
 	struct _data_ref
 	{
-		lak::shared_ptr<_data_ref> _parent = {};
-		lak::span<byte_t> _parent_span     = {};
-		lak::array<byte_t> _data           = {};
+		lak::shared_ptr<_data_ref> _parent      = {};
+		lak::span<byte_t> _parent_span          = {};
+		lak::array<byte_t> _data                = {};
+		lak::shared_ptr<mapped_file_t> _mapping = {};
 
 		_data_ref()                             = default;
 		_data_ref(const _data_ref &)            = default;
@@ -24,6 +27,12 @@ namespace SourceExplorer
 		{
 		}
 
+		_data_ref(lak::shared_ptr<mapped_file_t> mapping)
+		: _parent(), _parent_span(), _data(), _mapping(lak::move(mapping))
+		{
+			ASSERT(_mapping);
+		}
+
 		_data_ref(const lak::shared_ptr<_data_ref> &parent,
 		          size_t offset,
 		          size_t count,
@@ -31,22 +40,30 @@ namespace SourceExplorer
 		: _parent(parent), _data(lak::move(data))
 		{
 			ASSERT(_parent);
-			_parent_span = lak::span(_parent->_data).subspan(offset, count);
+			_parent_span = _parent->span().subspan(offset, count);
 		}
 
 		inline lak::shared_ptr<_data_ref> parent() const { return _parent; }
 		inline lak::span<byte_t> parent_span() const { return _parent_span; }
-		inline size_t size() const { return _data.size(); }
-		inline const byte_t *data() const { return _data.data(); }
-		inline byte_t *data() { return _data.data(); }
-		inline const lak::array<byte_t> &get() const { return _data; }
-		inline lak::array<byte_t> &get() { return _data; }
+		inline const lak::shared_ptr<mapped_file_t> &mapping() const
+		{
+			return _mapping;
+		}
 
-		inline operator lak::span<const byte_t>() const
+		// The bytes this ref owns, either a memory mapped file or an array.
+		inline lak::span<byte_t> span() const
 		{
-			return lak::span(_data);
+			if (_mapping) return _mapping->view();
+			return lak::span<byte_t>(const_cast<byte_t *>(_data.data()),
+			                         _data.size());
 		}
-		inline operator lak::span<byte_t>() { return lak::span(_data); }
+
+		inline size_t size() const { return span().size(); }
+		inline const byte_t *data() const { return span().data(); }
+		inline byte_t *data() { return span().data(); }
+
+		inline operator lak::span<const byte_t>() const { return span(); }
+		inline operator lak::span<byte_t>() { return span(); }
 	};
 
 	using data_ref_ptr_t = lak::shared_ptr<_data_ref>;
@@ -56,6 +73,12 @@ namespace SourceExplorer
 		return lak::shared_ptr<_data_ref>::make(lak::move(data));
 	}
 
+	static data_ref_ptr_t make_data_ref_ptr(
+	  lak::shared_ptr<mapped_file_t> mapping)
+	{
+		return lak::shared_ptr<_data_ref>::make(lak::move(mapping));
+	}
+
 	static data_ref_ptr_t make_data_ref_ptr(data_ref_ptr_t parent,
 	                                        size_t offset,
 	                                        size_t count,
@@ -76,11 +99,12 @@ namespace SourceExplorer
 		data_ref_span_t(data_ref_ptr_t src,
 		                size_t offset = 0,
 		                size_t count  = lak::dynamic_extent)
-		: lak::span<byte_t>(
-		    src ? lak::span<byte_t>(src->get()).subspan(offset, count)
-		        : lak::span<byte_t>()),
+		: lak::span<byte_t>(src ? src->span().subspan(offset, count)
+		                        : lak::span<byte_t>()),
 		  _source(src)
 		{
+			if (_source && _source->_mapping)
+				_source->_mapping->touch(size_t(data() - _source->data()), size());
 		}
 
 		data_ref_span_t ref_subspan(size_t offset = 0,
@@ -101,7 +125,7 @@ namespace SourceExplorer
 			if (!_source || !_source->_parent) return {};
 			return data_ref_span_t(_source->_parent,
 			                       _source->_parent_span.begin() -
-			                         _source->_parent->_data.begin(),
+			                         _source->_parent->span().begin(),
 			                       _source->_parent_span.size());
 		}
 
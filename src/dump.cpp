@@ -33,15 +33,17 @@ SOFTWARE.
 
 #include <lak/array.hpp>
 #include <lak/char_utils.hpp>
+#include <lak/defer.hpp>
 #include <lak/result.hpp>
 #include <lak/string.hpp>
 #include <lak/string_literals.hpp>
 #include <lak/string_utils.hpp>
-#include <lak/tasks.hpp>
 #include <lak/visit.hpp>
 
 #include <algorithm>
+#include <cstring>
 #include <execution>
+#include <unordered_map>
 #include <unordered_set>
 
 #ifdef GetObject
@@ -51,14 +53,22 @@ SOFTWARE.
 namespace se = SourceExplorer;
 
 se::error_t se::SaveImage(const lak::image4_t &image, const fs::path &filename)
+{
+	return SaveImage(
+	  lak::span(image.data(), image.contig_size()), image.size(), filename);
+}
+
+se::error_t se::SaveImage(lak::span<const lak::color4_t> pixels,
+                          lak::vec2s_t size,
+                          const fs::path &filename)
 {
 	if (stbi_write_png(
 	      reinterpret_cast<const char *>(filename.u8string().c_str()),
-	      (int)image.size().x,
-	      (int)image.size().y,
+	      (int)size.x,
+	      (int)size.y,
 	      4,
-	      &(image[0].r),
-	      (int)(image.size().x * 4)) != 1)
+	      &(pixels.data()->r),
+	      (int)(size.x * 4)) != 1)
 	{
 		return lak::err_t{
 		  se::error(lak::streamify("Failed to save image '", filename, "'"))};
@@ -85,157 +95,497 @@ se::error_t se::SaveImage(source_explorer_t &srcexp,
 	  .and_then([&](const auto &image) { return SaveImage(image, filename); });
 }
 
-lak::await_result<se::error_t> se::OpenGame(source_explorer_t &srcexp)
+// Only ever touched from the UI thread.
+static lak::array<se::job_ptr_t> auto_dump_jobs;
+
+lak::await_result<se::error_t> se::OpenGame(source_explorer_t &srcexp,
+                                            bool auto_dump)
 {
-	static lak::await<se::error_t> awaiter;
+	static job_ptr_t job;
+	static lak::await_result<se::error_t> result =
+	  lak::err_t{lak::await_error::failed};
+
+	if (!job)
+	{
+		result = lak::err_t{lak::await_error::failed};
+
+		job = scheduler().submit(
+		  "Open Game",
+		  job_priority_t::high,
+		  true,
+		  [&srcexp](const job_ptr_t &job)
+		  {
+			  try
+			  {
+				  result = lak::ok_t{LoadGame(srcexp)};
+			  }
+			  catch (const std::exception &e)
+			  {
+				  ERROR("Uncaught Exception: ", e.what());
+			  }
+			  catch (...)
+			  {
+				  ERROR("Uncaught Exception");
+			  }
+			  // Cancels anything that was waiting on the game to load.
+			  if (result.is_err() || result.unsafe_unwrap().is_err()) job->cancel();
+		  });
+
+		if (auto_dump) AutoDump(srcexp, job);
+	}
 
-	if (auto result = awaiter(LoadGame, std::ref(srcexp)); result.is_ok())
+	if (job->finished())
 	{
-		return lak::ok_t{result.unwrap().RES_ADD_TRACE("OpenGame")};
+		job = job_ptr_t();
+		if (result.is_ok())
+			return lak::ok_t{result.unwrap().RES_ADD_TRACE("OpenGame")};
+		else
+			return lak::err_t{lak::await_error::failed};
 	}
-	else
+
+	const auto str_id = "Open Game";
+	if (ImGui::BeginPopup(str_id, ImGuiWindowFlags_AlwaysAutoResize))
 	{
-		switch (result.unwrap_err())
+		ImGui::Text("Loading, please wait...");
+		ImGui::Checkbox("Print to debug console?",
+		                &lak::debugger.live_output_enabled);
+		if (lak::debugger.live_output_enabled)
 		{
-			case lak::await_error::running:
-			{
-				const auto str_id = "Open Game";
-				if (ImGui::BeginPopup(str_id, ImGuiWindowFlags_AlwaysAutoResize))
-				{
-					ImGui::Text("Loading, please wait...");
-					ImGui::Checkbox("Print to debug console?",
-					                &lak::debugger.live_output_enabled);
-					if (lak::debugger.live_output_enabled)
-					{
-						ImGui::Checkbox("Only errors?", &lak::debugger.live_errors_only);
-						ImGui::Checkbox("Developer mode?",
-						                &lak::debugger.line_info_enabled);
-					}
-					ImGui::ProgressBar(srcexp.state.completed);
-					ImGui::ProgressBar(srcexp.state.bank_completed);
-					ImGui::ProgressBar(srcexp.state.item_completed);
-					ImGui::EndPopup();
-				}
-				else
-				{
-					ImGui::OpenPopup(str_id);
-				}
+			ImGui::Checkbox("Only errors?", &lak::debugger.live_errors_only);
+			ImGui::Checkbox("Developer mode?", &lak::debugger.line_info_enabled);
+		}
+		ImGui::ProgressBar(srcexp.state.completed);
+		ImGui::ProgressBar(srcexp.state.bank_completed);
+		ImGui::ProgressBar(srcexp.state.item_completed);
+		ImGui::EndPopup();
+	}
+	else
+	{
+		ImGui::OpenPopup(str_id);
+	}
 
-				return lak::err_t{lak::await_error::running};
-			}
-			break;
+	return lak::err_t{lak::await_error::running};
+}
 
-			case lak::await_error::failed:
-				return lak::err_t{lak::await_error::failed};
-				break;
+void se::AutoDump(source_explorer_t &srcexp, const job_ptr_t &load)
+{
+	// Autotragically dump everything
 
-			default:
-				ASSERT_NYI();
-				// return lak::err_t{lak::await_error::failed};
-				// break;
-		}
+	struct stage_t
+	{
+		const char *name;
+		file_state_t source_explorer_t::*file;
+		const char *folder;
+		bool (*present)(const source_explorer_t &);
+		dump_function_t *func;
+	};
+
+	static const stage_t stages[] = {
+	  {
+	    "Saving images",
+	    &source_explorer_t::images,
+	    "images",
+	    [](const source_explorer_t &srcexp)
+	    { return srcexp.state.game.image_bank.is_present(); },
+	    [](source_explorer_t &srcexp, const job_ptr_t &job)
+	    {
+		    if (srcexp.state.two_five_plus_game)
+			    DumpImages(srcexp, job);
+		    else
+			    DumpSortedImages(srcexp, job);
+	    },
+	  },
+	  {
+	    "Saving app icon",
+	    &source_explorer_t::appicon,
+	    "icon",
+	    [](const source_explorer_t &srcexp)
+	    { return bool(srcexp.state.game.icon); },
+	    &DumpAppIcon,
+	  },
+	  {
+	    "Saving sounds",
+	    &source_explorer_t::sounds,
+	    "sounds",
+	    [](const source_explorer_t &srcexp)
+	    { return srcexp.state.game.sound_bank.is_present(); },
+	    &DumpSounds,
+	  },
+	  {
+	    "Saving music",
+	    &source_explorer_t::music,
+	    "music",
+	    [](const source_explorer_t &srcexp)
+	    { return srcexp.state.game.music_bank.is_present(); },
+	    &DumpMusic,
+	  },
+	  {
+	    "Saving shaders",
+	    &source_explorer_t::shaders,
+	    "shaders",
+	    [](const source_explorer_t &srcexp)
+	    { return bool(srcexp.state.game.shaders); },
+	    &DumpShaders,
+	  },
+	  {
+	    "Saving binary files",
+	    &source_explorer_t::binary_files,
+	    "binary_files",
+	    [](const source_explorer_t &srcexp)
+	    { return bool(srcexp.state.game.binary_files); },
+	    &DumpBinaryFiles,
+	  },
+	};
+
+	fs::path dump_dir = srcexp.exe.path.parent_path() / srcexp.exe.path.stem();
+
+	// Every path is set before any stage is submitted, the stages read them
+	// from their own threads.
+	for (const auto &stage : stages)
+		(srcexp.*stage.file).path = dump_dir / stage.folder;
+
+	// DumpSortedImages saves to a different file state than DumpImages.
+	srcexp.sorted_images.path = srcexp.images.path;
+
+	for (const auto &stage : stages)
+	{
+		// Every stage only waits on the load, they all run side by side.
+		auto stage_job = scheduler().submit(
+		  stage.name,
+		  job_priority_t::normal,
+		  srcexp.allow_multithreading,
+		  [&srcexp, &stage](const job_ptr_t &job)
+		  {
+			  if (!stage.present(srcexp)) return;
+
+			  const fs::path &path = (srcexp.*stage.file).path;
+			  std::error_code er;
+			  if (fs::create_directories(path, er); er)
+			  {
+				  ERROR("Failed To Dump ", stage.folder);
+				  ERROR("File System Error: (", er.value(), ")", er.message());
+				  return;
+			  }
+
+			  stage.func(srcexp, job);
+		  },
+		  lak::span(&load, 1));
+
+		auto_dump_jobs.push_back(lak::move(stage_job));
 	}
 }
 
+// Only ever touched from the UI thread.
+static std::unordered_map<se::dump_function_t *, se::job_ptr_t> dump_jobs;
+
 lak::file_open_error se::DumpStuff(source_explorer_t &srcexp,
                                    const char *str_id,
                                    dump_function_t *func)
 {
-	static lak::await<se::error_t> awaiter;
-	static std::atomic<float> completed = 0.0f;
+	auto &job = dump_jobs[func];
 
-	auto functor = [&, func]() -> se::error_t
+	if (!job)
 	{
-		completed = 0.0f;
-		func(srcexp, completed);
-		return lak::ok_t{};
-	};
+		job = scheduler().submit(str_id,
+		                         job_priority_t::normal,
+		                         srcexp.allow_multithreading,
+		                         [&srcexp, func](const job_ptr_t &job)
+		                         { func(srcexp, job); });
+	}
+
+	if (!job->finished()) return lak::file_open_error::INCOMPLETE;
+
+	const bool cancelled = job->cancelled();
+	dump_jobs.erase(func);
+	return cancelled ? lak::file_open_error::CANCELED
+	                 : lak::file_open_error::VALID;
+}
 
-	if (auto result = awaiter(functor); result.is_ok())
+void se::DumpProgress()
+{
+	// Finished auto dump jobs stay up until the whole dump is done.
+	if (std::all_of(auto_dump_jobs.begin(),
+	                auto_dump_jobs.end(),
+	                [](const job_ptr_t &job) { return job->finished(); }))
+		auto_dump_jobs.clear();
+
+	if (dump_jobs.empty() && auto_dump_jobs.empty()) return;
+
+	const auto str_id = "Dumping";
+	if (ImGui::BeginPopup(str_id, ImGuiWindowFlags_AlwaysAutoResize))
 	{
-		return lak::file_open_error::VALID;
+		ImGui::Text("Saving, please wait...");
+		ImGui::Checkbox("Print to debug console?",
+		                &lak::debugger.live_output_enabled);
+		if (lak::debugger.live_output_enabled)
+		{
+			ImGui::Checkbox("Only errors?", &lak::debugger.live_errors_only);
+			ImGui::Checkbox("Developer mode?", &lak::debugger.line_info_enabled);
+		}
+		auto job_progress = [](const job_ptr_t &job)
+		{
+			ImGui::PushID(job->name.c_str());
+			ImGui::Text("%s", job->name.c_str());
+			ImGui::ProgressBar(job->progress());
+			ImGui::SameLine();
+			if (job->cancelled())
+				ImGui::Text("Cancelling...");
+			else if (ImGui::Button("Cancel"))
+				job->cancel();
+			ImGui::PopID();
+		};
+		for (const auto &job : auto_dump_jobs) job_progress(job);
+		for (const auto &entry : dump_jobs) job_progress(entry.second);
+		ImGui::EndPopup();
 	}
 	else
 	{
-		switch (result.unwrap_err())
-		{
-			case lak::await_error::running:
-			{
-				if (ImGui::BeginPopup(str_id, ImGuiWindowFlags_AlwaysAutoResize))
-				{
-					ImGui::Text("%s, please wait...", str_id);
-					ImGui::Checkbox("Print to debug console?",
-					                &lak::debugger.live_output_enabled);
-					if (lak::debugger.live_output_enabled)
-					{
-						ImGui::Checkbox("Only errors?", &lak::debugger.live_errors_only);
-						ImGui::Checkbox("Developer mode?",
-						                &lak::debugger.line_info_enabled);
-					}
-					ImGui::ProgressBar(completed);
-					ImGui::EndPopup();
-				}
-				else
-				{
-					ImGui::OpenPopup(str_id);
-				}
-				return lak::file_open_error::INCOMPLETE;
-			}
-			break;
+		ImGui::OpenPopup(str_id);
+	}
+}
 
-			case lak::await_error::failed:
-				return lak::file_open_error::INVALID;
+size_t se::dump_item_limit   = 0;
+size_t se::dump_byte_limit   = 0x10000000;
+se::file_sink_t se::dump_sink = se::file_sink_t::sync;
 
-			default:
+// Every item any dump has between being handed over and having been written
+// out, and roughly how much memory they hold.
+static struct
+{
+	std::mutex mutex;
+	size_t items = 0;
+	size_t bytes = 0;
+} dump_window;
+
+// One item's place in the dump window. The place is given back, and the item
+// counted as done, once the last task or file write holding it has gone,
+// however that finished. The job can't finish before then.
+struct dump_slot_t
+{
+	se::job_ptr_t job;
+	size_t bytes = 0;
+	// False if the job was cancelled before the item got in.
+	bool entered = false;
+
+	~dump_slot_t()
+	{
+		++job->steps_done;
+		if (entered)
+		{
 			{
-				ASSERT_NYI();
-				return lak::file_open_error::INVALID;
+				std::lock_guard lock(dump_window.mutex);
+				--dump_window.items;
+				dump_window.bytes -= bytes;
 			}
+			se::scheduler().notify();
 		}
+		se::scheduler().unhold(job);
 	}
+};
+
+using dump_slot_ptr_t = lak::shared_ptr<dump_slot_t>;
+
+// Blocks until the dump window has room for another item that will hold about
+// bytes of memory. An item is always let in when the window is empty, however
+// big it is.
+static dump_slot_ptr_t EnterDumpWindow(const se::job_ptr_t &job, size_t bytes)
+{
+	const size_t item_limit = se::dump_item_limit
+	                            ? se::dump_item_limit
+	                            : se::scheduler().thread_count() * 4;
+
+	auto try_enter = [&]
+	{
+		std::lock_guard lock(dump_window.mutex);
+		if (dump_window.items > 0 &&
+		    (dump_window.items >= item_limit ||
+		     dump_window.bytes + bytes > se::dump_byte_limit))
+			return false;
+		++dump_window.items;
+		dump_window.bytes += bytes;
+		return true;
+	};
+
+	// Only help with this dump's own tasks, the caller may be a bank reader
+	// holding the bank's lock. Other dumps' items are finished by their own
+	// producers or the workers.
+	bool entered = false;
+	se::scheduler().wait_until(
+	  [&] { return (entered = try_enter()) || job->cancelled(); }, &*job);
+
+	auto slot     = dump_slot_ptr_t::make();
+	slot->job     = job;
+	slot->bytes   = bytes;
+	slot->entered = entered;
+	se::scheduler().hold(job);
+	return slot;
 }
 
-void se::DumpImages(source_explorer_t &srcexp, std::atomic<float> &completed)
+// The decoded data and the file made from it.
+static size_t ItemDumpBytes(const se::basic_item_t &item)
 {
-	if (!srcexp.state.game.image_bank)
+	return 2 * std::max(item.entry.body.expected_size,
+	                    item.entry.raw_body().size());
+}
+
+// One writer per sink, started the first time a dump uses it.
+static se::file_writer_t &DumpWriter(se::file_sink_t sink)
+{
+	static std::mutex mutex;
+	static lak::shared_ptr<se::file_writer_t> writers[se::file_sink_count];
+
+	std::lock_guard lock(mutex);
+	auto &writer = writers[static_cast<size_t>(sink)];
+	if (!writer)
+		writer = se::file_writer_t::open(
+		  sink, std::max<size_t>(se::scheduler().thread_count(), 4U));
+	return *writer;
+}
+
+// The last stage of every item dump, writes data out to path.
+static void WriteDumpFile(const dump_slot_ptr_t &slot,
+                          fs::path path,
+                          lak::array<byte_t> data)
+{
+	if (const se::file_sink_t sink = se::dump_sink;
+	    sink != se::file_sink_t::sync)
 	{
-		ERROR("No Image Bank");
+		// The slot stays held until the file is on disk, so the dump window
+		// also bounds how much is waiting on the writer.
+		DumpWriter(sink).write(
+		  lak::move(path), lak::move(data), [slot](bool) {});
 		return;
 	}
 
-	auto tasks{srcexp.allow_multithreading ? lak::tasks::hardware_max()
-	                                       : lak::tasks(1)};
+	se::scheduler().spawn(
+	  slot->job,
+	  [slot, path = lak::move(path), data = lak::move(data)](
+	    const se::job_ptr_t &)
+	  {
+		  DEBUG("Saving '", lak::to_u8string(path), "'");
+		  if (!lak::save_file(path, data))
+		  {
+			  ERROR("Failed To Save File '", path, "'");
+		  }
+	  });
+}
+
+// Hands every item in bank to dump, adding a step to job for each. With
+// stream_dumps and a bank that hasn't been read yet, each item is handed over
+// as soon as the reader gets to it.
+template<typename BANK, typename ITEM, typename DUMP>
+static bool ForEachItem(const se::job_ptr_t &job,
+                        se::lazy_chunk_ptr<BANK> &bank,
+                        std::function<void(const ITEM &)> &on_read,
+                        DUMP dump)
+{
+	std::unordered_set<const ITEM *> dumped;
+
+	if (se::stream_dumps && !bank.is_loaded())
+	{
+		// on_read is only set while this thread holds the bank's lock, so it is
+		// only ever called from the read this thread is doing. If someone else
+		// gets to the bank first, this just waits for them and dumps it after.
+		bank
+		  .load(
+		    [&](bool reading)
+		    {
+			    if (!reading)
+			    {
+				    on_read = nullptr;
+				    return;
+			    }
+			    on_read = [&](const ITEM &item)
+			    {
+				    dumped.insert(&item);
+				    ++job->steps;
+				    dump(item);
+			    };
+		    })
+		  .IF_ERR("Failed To Load Bank")
+		  .discard();
+	}
+
+	if (!bank) return false;
+
+	// Anything the reader didn't hand over, which is everything if the bank was
+	// already loaded. These are all counted up front so the progress doesn't
+	// sit near the end while they're let in one at a time.
+	job->steps += bank->items.size() - dumped.size();
+	for (const auto &item : bank->items)
+		if (dumped.find(&item) == dumped.end()) dump(item);
+
+	return true;
+}
 
-	auto do_dump = [](source_explorer_t &srcexp,
-	                  const se::image::item_t &item) -> se::error_t
+void se::DumpImages(source_explorer_t &srcexp, const job_ptr_t &job)
+{
+	// Decode and encode in one task so the decoded pixels never have to wait
+	// around for a worker, only the much smaller PNG does.
+	auto encode = [&srcexp](const se::image::item_t &item,
+	                        lak::array<byte_t> &png) -> se::error_t
 	{
-		RES_TRY_ASSIGN(lak::image4_t image =,
-		               item.image(srcexp.dump_color_transparent)
-		                 .RES_ADD_TRACE("Image ", item.entry.handle, " Failed"));
-		fs::path filename =
-		  srcexp.images.path / (std::to_string(item.entry.handle) + ".png");
-		return SaveImage(image, filename).RES_ADD_TRACE("Save Failed");
+		// Each worker decodes into the same buffer for every image it dumps,
+		// rather than allocating a new image each time. Anything bigger than
+		// 1 MiB is let go afterwards, it would otherwise live as long as the
+		// worker does, outside of the dump window.
+		thread_local lak::array<lak::color4_t> pixels;
+		DEFER(if (pixels.size() > 0x40000) pixels = lak::array<lak::color4_t>());
+		const lak::vec2s_t size(item.size);
+		pixels.resize(size.x * size.y);
+		RES_TRY(item.image_into(lak::span(pixels), srcexp.dump_color_transparent)
+		          .RES_ADD_TRACE("Image ", item.entry.handle, " Failed"));
+
+		stbi_write_func *append = [](void *context, void *data, int len)
+		{
+			auto &out         = *static_cast<lak::array<byte_t> *>(context);
+			const size_t used = out.size();
+			out.resize(used + len);
+			std::memcpy(out.data() + used, data, len);
+		};
+		if (stbi_write_png_to_func(append,
+		                           &png,
+		                           (int)size.x,
+		                           (int)size.y,
+		                           4,
+		                           &(pixels.data()->r),
+		                           (int)(size.x * 4)) != 1)
+		{
+			return lak::err_t{se::error(
+			  lak::streamify("Failed to encode image ", item.entry.handle))};
+		}
+		return lak::ok_t{};
 	};
 
-	const size_t count = srcexp.state.game.image_bank->items.size();
-	std::atomic_size_t completed_index = 0;
-	size_t loop_index                  = 0;
-	for (const auto &item : srcexp.state.game.image_bank->items)
+	auto dump = [&srcexp, &job, encode](const se::image::item_t &item)
 	{
-		++loop_index;
-		SCOPED_CHECKPOINT(
-		  "Image ", loop_index, "/", count, " (", item.entry.handle, ")");
-		tasks.push(
-		  [&]
+		// The decoded pixels, the compressed data they came from and the PNG.
+		const size_t bytes = (size_t(item.size.x) * item.size.y * 4 * 2) +
+		                     item.entry.body.expected_size;
+		scheduler().spawn(
+		  job,
+		  [&srcexp, &item, encode, slot = EnterDumpWindow(job, bytes)](
+		    const job_ptr_t &)
 		  {
-			  do_dump(srcexp, item).IF_ERR("Dump Failed");
-			  completed = (float)((double)(++completed_index) / (double)count);
+			  SCOPED_CHECKPOINT("Image (", item.entry.handle, ")");
+			  lak::array<byte_t> png;
+			  if (encode(item, png).IF_ERR("Dump Failed").is_err()) return;
+			  WriteDumpFile(
+			    slot,
+			    srcexp.images.path / (std::to_string(item.entry.handle) + ".png"),
+			    lak::move(png));
 		  });
+	};
+
+	if (!ForEachItem(
+	      job, srcexp.state.game.image_bank, srcexp.state.on_image_read, dump))
+	{
+		ERROR("No Image Bank");
 	}
 }
 
 void se::DumpSortedImages(se::source_explorer_t &srcexp,
-                          std::atomic<float> &completed)
+                          const job_ptr_t &job)
 {
 	if (!srcexp.state.game.image_bank)
 	{
@@ -332,25 +682,15 @@ void se::DumpSortedImages(se::source_explorer_t &srcexp,
 	fs::path root_path     = srcexp.sorted_images.path;
 	fs::path unsorted_path = root_path / "[unsorted]";
 	fs::create_directories(unsorted_path);
-	std::error_code err;
 
-	size_t image_index       = 0;
 	const size_t image_count = srcexp.state.game.image_bank->items.size();
-	for (const auto &image : srcexp.state.game.image_bank->items)
-	{
-		SCOPED_CHECKPOINT(
-		  "Image ", image_index, "/", image_count, " (", image.entry.handle, ")");
-		lak::u16string image_name = se::to_u16string(image.entry.handle) + u".png";
-		fs::path image_path       = unsorted_path / image_name;
-		(void)SaveImage(image.image(srcexp.dump_color_transparent).UNWRAP(),
-		                image_path);
-		completed = (float)((double)++image_index / image_count);
-	}
-
-	size_t frame_index       = 0;
 	const size_t frame_count = srcexp.state.game.frame_bank->items.size();
-	for (const auto &frame : srcexp.state.game.frame_bank->items)
+	job->steps += image_count + frame_count;
+
+	auto dump_frame =
+	  [=, &srcexp](const frame::item_t &frame, size_t frame_index)
 	{
+		std::error_code err;
 		SCOPED_CHECKPOINT("Frame ",
 		                  frame_index,
 		                  "/",
@@ -364,7 +704,7 @@ void se::DumpSortedImages(se::source_explorer_t &srcexp,
 		if (err)
 		{
 			ERROR("File System Error: (", err.value(), ")", err.message());
-			continue;
+			return;
 		}
 
 		if (frame.object_instances)
@@ -461,11 +801,56 @@ void se::DumpSortedImages(se::source_explorer_t &srcexp,
 				}
 			}
 		}
-		completed = (float)((double)++frame_index / frame_count);
+	};
+
+	auto dump_frames = [&srcexp, dump_frame](const job_ptr_t &job)
+	{
+		size_t frame_index = 0;
+		for (const auto &frame : srcexp.state.game.frame_bank->items)
+		{
+			scheduler().spawn(job,
+			                  [&frame, dump_frame, index = frame_index++](
+			                    const job_ptr_t &job)
+			                  {
+				                  dump_frame(frame, index);
+				                  ++job->steps_done;
+			                  });
+		}
+	};
+
+	// The frames link to the unsorted images, so they can only start once the
+	// last of the images has been saved.
+	auto images_left = lak::shared_ptr<std::atomic_size_t>::make();
+	*images_left     = image_count;
+	if (image_count == 0) dump_frames(job);
+
+	size_t image_index = 0;
+	for (const auto &image : srcexp.state.game.image_bank->items)
+	{
+		scheduler().spawn(
+		  job,
+		  [&srcexp,
+		   &image,
+		   unsorted_path,
+		   image_count,
+		   images_left,
+		   dump_frames,
+		   index = image_index++](const job_ptr_t &job)
+		  {
+			  SCOPED_CHECKPOINT(
+			    "Image ", index, "/", image_count, " (", image.entry.handle, ")");
+			  lak::u16string image_name =
+			    se::to_u16string(image.entry.handle) + u".png";
+			  fs::path image_path = unsorted_path / image_name;
+			  (void)SaveImage(image.image(srcexp.dump_color_transparent).UNWRAP(),
+			                  image_path);
+			  ++job->steps_done;
+			  if (--*images_left == 0) dump_frames(job);
+		  });
 	}
 }
 
-void se::DumpAppIcon(source_explorer_t &srcexp, std::atomic<float> &)
+void se::DumpAppIcon(source_explorer_t &srcexp, const job_ptr_t &)
 {
 	if (!srcexp.state.game.icon)
 	{
@@ -514,29 +899,17 @@ void se::DumpAppIcon(source_explorer_t &srcexp, std::atomic<float> &)
 	file.close();
 }
 
-void se::DumpSounds(source_explorer_t &srcexp, std::atomic<float> &completed)
+void se::DumpSounds(source_explorer_t &srcexp, const job_ptr_t &job)
 {
-	if (!srcexp.state.game.sound_bank)
-	{
-		ERROR("No Sound Bank");
-		return;
-	}
-
-	auto tasks{srcexp.allow_multithreading ? lak::tasks::hardware_max()
-	                                       : lak::tasks(1)};
-
-	const size_t count = srcexp.state.game.sound_bank->items.size();
-	std::atomic_size_t completed_index = 0;
-	size_t loop_index                  = 0;
-	for (const auto &item : srcexp.state.game.sound_bank->items)
+	auto dump = [&srcexp, &job](const se::sound::item_t &item)
 	{
-		++loop_index;
-		SCOPED_CHECKPOINT(
-		  "Sound ", loop_index, "/", count, " (", item.entry.handle, ")");
-
-		tasks.push(
-		  [&]
+		scheduler().spawn(
+		  job,
+		  [&srcexp, &item, slot = EnterDumpWindow(job, ItemDumpBytes(item))](
+		    const job_ptr_t &)
 		  {
+			  SCOPED_CHECKPOINT("Sound (", item.entry.handle, ")");
+
 			  data_reader_t sound(item.entry.decode_body().EXPECT(
 			    "Item ", item.entry.handle, " Body Failed To Decode"));
 			  lak::array<byte_t> result;
@@ -648,43 +1021,28 @@ void se::DumpSounds(source_explorer_t &srcexp, std::atomic<float> &completed)
 
 			  DEBUG("Sound ", (size_t)item.entry.ID);
 
-			  fs::path filename = srcexp.sounds.path / name;
-
-			  DEBUG("Saving '", lak::to_u8string(filename), "'");
-
-			  if (!lak::save_file(filename, result))
-			  {
-				  ERROR("Failed To Save File '", filename, "'");
-			  }
-
-			  completed = (float)((double)(++completed_index) / (double)count);
+			  WriteDumpFile(slot, srcexp.sounds.path / name, lak::move(result));
 		  });
-	}
-}
+	};
 
-void se::DumpMusic(source_explorer_t &srcexp, std::atomic<float> &completed)
-{
-	if (!srcexp.state.game.music_bank)
+	if (!ForEachItem(
+	      job, srcexp.state.game.sound_bank, srcexp.state.on_sound_read, dump))
 	{
-		ERROR("No Music Bank");
-		return;
+		ERROR("No Sound Bank");
 	}
+}
 
-	auto tasks{srcexp.allow_multithreading ? lak::tasks::hardware_max()
-	                                       : lak::tasks(1)};
-
-	const size_t count = srcexp.state.game.music_bank->items.size();
-	std::atomic_size_t completed_index = 0;
-	size_t loop_index                  = 0;
-	for (const auto &item : srcexp.state.game.music_bank->items)
+void se::DumpMusic(source_explorer_t &srcexp, const job_ptr_t &job)
+{
+	auto dump = [&srcexp, &job](const se::music::item_t &item)
 	{
-		++loop_index;
-		SCOPED_CHECKPOINT(
-		  "Music ", loop_index, "/", count, " (", item.entry.handle, ")");
-
-		tasks.push(
-		  [&]
+		scheduler().spawn(
+		  job,
+		  [&srcexp, &item, slot = EnterDumpWindow(job, ItemDumpBytes(item))](
+		    const job_ptr_t &)
 		  {
+			  SCOPED_CHECKPOINT("Music (", item.entry.handle, ")");
+
 			  data_reader_t sound(item.entry.decode_body().EXPECT(
 			    "Item ", item.entry.handle, " Body Failed To Decode"));
 
@@ -738,19 +1096,21 @@ void se::DumpMusic(source_explorer_t &srcexp, std::atomic<float> &completed)
 					  break;
 			  }
 
-			  fs::path filename = srcexp.music.path / name;
-
-			  if (!lak::save_file(filename, sound.remaining()))
-			  {
-				  ERROR("Failed To Save File '", filename, "'");
-			  }
-
-			  completed = (float)((double)(++completed_index) / (double)count);
+			  WriteDumpFile(slot,
+			                srcexp.music.path / name,
+			                lak::array<byte_t>(sound.remaining().begin(),
+			                                   sound.remaining().end()));
 		  });
+	};
+
+	if (!ForEachItem(
+	      job, srcexp.state.game.music_bank, srcexp.state.on_music_read, dump))
+	{
+		ERROR("No Music Bank");
 	}
 }
 
-void se::DumpShaders(source_explorer_t &srcexp, std::atomic<float> &completed)
+void se::DumpShaders(source_explorer_t &srcexp, const job_ptr_t &job)
 {
 	if (!srcexp.state.game.shaders)
 	{
@@ -766,8 +1126,12 @@ void se::DumpShaders(source_explorer_t &srcexp, std::atomic<float> &completed)
 
 	while (count-- > 0) offsets.push_back(strm.read_u32().UNWRAP());
 
+	job->steps += offsets.size();
+
 	for (auto offset : offsets)
 	{
+		if (job->cancelled()) return;
+
 		strm.seek(offset).UNWRAP();
 		uint32_t name_offset                   = strm.read_u32().UNWRAP();
 		uint32_t data_offset                   = strm.read_u32().UNWRAP();
@@ -780,21 +1144,27 @@ void se::DumpShaders(source_explorer_t &srcexp, std::atomic<float> &completed)
 		strm.seek(offset + data_offset).UNWRAP();
 		lak::astring file = strm.read_c_str<char>().UNWRAP();
 
-		DEBUG(filename);
-		if (!lak::save_file(
-		      filename,
-		      lak::span(reinterpret_cast<const byte_t *>(file.c_str()),
-		                file.size())))
-		{
-			ERROR("Failed To Save File '", filename, "'");
-		}
-
-		completed = (float)((double)++count / (double)offsets.size());
+		// The shaders all come out of one stream, so only the saving is split
+		// into tasks.
+		scheduler().spawn(
+		  job,
+		  [filename = lak::move(filename),
+		   file     = lak::move(file)](const job_ptr_t &job)
+		  {
+			  DEBUG(filename);
+			  if (!lak::save_file(
+			        filename,
+			        lak::span(reinterpret_cast<const byte_t *>(file.c_str()),
+			                  file.size())))
+			  {
+				  ERROR("Failed To Save File '", filename, "'");
+			  }
+			  ++job->steps_done;
+		  });
 	}
 }
 
-void se::DumpBinaryFiles(source_explorer_t &srcexp,
-                         std::atomic<float> &completed)
+void se::DumpBinaryFiles(source_explorer_t &srcexp, const job_ptr_t &job)
 {
 	if (!srcexp.state.game.binary_files)
 	{
@@ -802,27 +1172,29 @@ void se::DumpBinaryFiles(source_explorer_t &srcexp,
 		return;
 	}
 
-	data_reader_t strm(
-	  srcexp.state.game.binary_files->entry.decode_body().UNWRAP());
-
 	const size_t count = srcexp.state.game.binary_files->items.size();
-	size_t index       = 0;
+	job->steps += count;
+	size_t loop_index = 0;
 	for (const auto &file : srcexp.state.game.binary_files->items)
 	{
-		++index;
-		SCOPED_CHECKPOINT("Binary ", index, "/", count, " (", file.name, ")");
-		fs::path filename = lak::to_u16string(file.name);
-		filename          = srcexp.binary_files.path / filename.filename();
-		DEBUG(filename);
-		if (!lak::save_file(filename, file.data))
-		{
-			ERROR("Failed To Save File '", filename, "'");
-		}
-		completed = (float)((double)index / (double)count);
+		scheduler().spawn(
+		  job,
+		  [&srcexp, &file, count, index = ++loop_index](const job_ptr_t &job)
+		  {
+			  SCOPED_CHECKPOINT("Binary ", index, "/", count, " (", file.name, ")");
+			  fs::path filename = lak::to_u16string(file.name);
+			  filename          = srcexp.binary_files.path / filename.filename();
+			  DEBUG(filename);
+			  if (!lak::save_file(filename, file.data))
+			  {
+				  ERROR("Failed To Save File '", filename, "'");
+			  }
+			  ++job->steps_done;
+		  });
 	}
 }
 
-void se::SaveErrorLog(source_explorer_t &srcexp, std::atomic<float> &)
+void se::SaveErrorLog(source_explorer_t &srcexp, const job_ptr_t &)
 {
 	if (!lak::save_file(srcexp.error_log.path, lak::debugger.str()))
 	{
@@ -830,7 +1202,7 @@ void se::SaveErrorLog(source_explorer_t &srcexp, std::atomic<float> &)
 	}
 }
 
-void se::SaveBinaryBlock(source_explorer_t &srcexp, std::atomic<float> &)
+void se::SaveBinaryBlock(source_explorer_t &srcexp, const job_ptr_t &)
 {
 	srcexp.binary_block.path += ".bin";
 	if (!lak::save_file(srcexp.binary_block.path,
@@ -848,7 +1220,7 @@ void se::AttemptExe(source_explorer_t &srcexp)
 	  srcexp.exe,
 	  [&srcexp]() -> lak::file_open_error
 	  {
-		  if (auto result = OpenGame(srcexp); result.is_err())
+		  if (auto result = OpenGame(srcexp, srcexp.baby_mode); result.is_err())
 		  {
 			  ASSERT(result.unwrap_err() == lak::await_error::running);
 			  return lak::file_open_error::INCOMPLETE;
@@ -865,108 +1237,6 @@ void se::AttemptExe(source_explorer_t &srcexp)
 		  else
 		  {
 			  srcexp.loaded = true;
-			  if (srcexp.baby_mode)
-			  {
-				  // Autotragically dump everything
-
-				  fs::path dump_dir =
-				    srcexp.exe.path.parent_path() / srcexp.exe.path.stem();
-
-				  std::error_code er;
-				  if (srcexp.state.game.image_bank)
-				  {
-					  file_state_t &images = srcexp.state.two_five_plus_game
-					                           ? srcexp.images
-					                           : srcexp.sorted_images;
-
-					  images.path = dump_dir / "images";
-					  if (fs::create_directories(images.path, er); er)
-					  {
-						  ERROR("Failed To Dump Images");
-						  ERROR("File System Error: (", er.value(), ")", er.message());
-					  }
-					  else
-					  {
-						  images.attempt = true;
-						  images.valid   = true;
-					  }
-				  }
-
-				  if (srcexp.state.game.icon)
-				  {
-					  srcexp.appicon.path = dump_dir / "icon";
-					  if (fs::create_directories(srcexp.appicon.path, er); er)
-					  {
-						  ERROR("Failed To Dump Icon");
-						  ERROR("File System Error: ", er.message());
-					  }
-					  else
-					  {
-						  srcexp.appicon.attempt = true;
-						  srcexp.appicon.valid   = true;
-					  }
-				  }
-
-				  if (srcexp.state.game.sound_bank)
-				  {
-					  srcexp.sounds.path = dump_dir / "sounds";
-					  if (fs::create_directories(srcexp.sounds.path, er); er)
-					  {
-						  ERROR("Failed To Dump Audio");
-						  ERROR("File System Error: ", er.message());
-					  }
-					  else
-					  {
-						  srcexp.sounds.attempt = true;
-						  srcexp.sounds.valid   = true;
-					  }
-				  }
-
-				  if (srcexp.state.game.music_bank)
-				  {
-					  srcexp.music.path = dump_dir / "music";
-					  if (fs::create_directories(srcexp.sounds.path, er); er)
-					  {
-						  ERROR("Failed To Dump Audio");
-						  ERROR("File System Error: ", er.message());
-					  }
-					  else
-					  {
-						  srcexp.music.attempt = true;
-						  srcexp.music.valid   = true;
-					  }
-				  }
-
-				  if (srcexp.state.game.shaders)
-				  {
-					  srcexp.shaders.path = dump_dir / "shaders";
-					  if (fs::create_directories(srcexp.shaders.path, er); er)
-					  {
-						  ERROR("Failed To Dump Shaders");
-						  ERROR("File System Error: ", er.message());
-					  }
-					  else
-					  {
-						  srcexp.shaders.attempt = true;
-						  srcexp.shaders.valid   = true;
-					  }
-				  }
-
-				  if (srcexp.state.game.binary_files)
-				  {
-					  srcexp.binary_files.path = dump_dir / "binary_files";
-					  if (fs::create_directories(srcexp.binary_files.path, er); er)
-					  {
-						  ERROR("Failed To Dump Binary Files");
-						  ERROR("File System Error: ", er.message());
-					  }
-					  else
-					  {
-						  srcexp.binary_files.attempt = true;
-						  srcexp.binary_files.valid   = true;
-					  }
-				  }
-			  }
 			  return lak::file_open_error::VALID;
 		  }
 	  },
@@ -25,6 +25,8 @@ SOFTWARE.
 #define SOURCE_EXPLORER_DUMP_H
 
 #include "ctf/explorer.hpp"
+#include "ctf/scheduler.hpp"
+#include "file_writer.hpp"
 
 #include <atomic>
 #include <tuple>
@@ -34,33 +36,57 @@ namespace SourceExplorer
 	[[nodiscard]] error_t SaveImage(const lak::image4_t &image,
 	                                const fs::path &filename);
 
+	[[nodiscard]] error_t SaveImage(lak::span<const lak::color4_t> pixels,
+	                                lak::vec2s_t size,
+	                                const fs::path &filename);
+
 	[[nodiscard]] error_t SaveImage(source_explorer_t &srcexp,
 	                                uint16_t handle,
 	                                const fs::path &filename,
 	                                const frame::item_t *frame);
 
-	[[nodiscard]] lak::await_result<error_t> OpenGame(source_explorer_t &srcexp);
+	// Loads the game on the shared scheduler. With auto_dump everything in the
+	// game is also dumped next to it as soon as the load finishes, without
+	// waiting on the UI to notice.
+	[[nodiscard]] lak::await_result<error_t> OpenGame(source_explorer_t &srcexp,
+	                                                  bool auto_dump = false);
+
+	// Queues a dump job for each part of the game to start once load finishes.
+	void AutoDump(source_explorer_t &srcexp, const job_ptr_t &load);
+
+	// The most items every running dump may have between being handed over and
+	// having been written out, 0 allows 4 per worker.
+	extern size_t dump_item_limit;
+	// Roughly how many bytes those items may hold at once. Dumps block when
+	// either limit is reached.
+	extern size_t dump_byte_limit;
 
-	using dump_data_t = std::tuple<source_explorer_t &, std::atomic<float> &>;
+	// Where image, sound and music dumps send their files. Anything but sync
+	// lets the dump move on to the next item while the file is written.
+	extern file_sink_t dump_sink;
 
-	using dump_function_t = void(source_explorer_t &, std::atomic<float> &);
+	// Dump functions run as the first task of a job on the shared scheduler and
+	// may spawn more tasks into that job.
+	using dump_function_t = void(source_explorer_t &, const job_ptr_t &);
 
+	// Starts func as a job the first time it is called, then reports INCOMPLETE
+	// until the job finishes. Dumps with different funcs run side by side.
 	lak::file_open_error DumpStuff(source_explorer_t &srcexp,
 	                               const char *str_id,
 	                               dump_function_t *func);
 
-	void DumpImages(source_explorer_t &srcexp, std::atomic<float> &completed);
-	void DumpSortedImages(source_explorer_t &srcexp,
-	                      std::atomic<float> &completed);
-	void DumpAppIcon(source_explorer_t &srcexp, std::atomic<float> &completed);
-	void DumpSounds(source_explorer_t &srcexp, std::atomic<float> &completed);
-	void DumpMusic(source_explorer_t &srcexp, std::atomic<float> &completed);
-	void DumpShaders(source_explorer_t &srcexp, std::atomic<float> &completed);
-	void DumpBinaryFiles(source_explorer_t &srcexp,
-	                     std::atomic<float> &completed);
-	void SaveErrorLog(source_explorer_t &srcexp, std::atomic<float> &completed);
-	void SaveBinaryBlock(source_explorer_t &srcexp,
-	                     std::atomic<float> &completed);
+	// Shows the progress of every running dump, with a button to cancel each.
+	void DumpProgress();
+
+	void DumpImages(source_explorer_t &srcexp, const job_ptr_t &job);
+	void DumpSortedImages(source_explorer_t &srcexp, const job_ptr_t &job);
+	void DumpAppIcon(source_explorer_t &srcexp, const job_ptr_t &job);
+	void DumpSounds(source_explorer_t &srcexp, const job_ptr_t &job);
+	void DumpMusic(source_explorer_t &srcexp, const job_ptr_t &job);
+	void DumpShaders(source_explorer_t &srcexp, const job_ptr_t &job);
+	void DumpBinaryFiles(source_explorer_t &srcexp, const job_ptr_t &job);
+	void SaveErrorLog(source_explorer_t &srcexp, const job_ptr_t &job);
+	void SaveBinaryBlock(source_explorer_t &srcexp, const job_ptr_t &job);
 
 	template<lak::concepts::invocable_result_of<lak::file_open_error,
 	                                            file_state_t &> LOAD,
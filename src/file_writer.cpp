@@ -0,0 +1,490 @@
+#include "file_writer.hpp"
+
+#include <lak/debug.hpp>
+#include <lak/file.hpp>
+
+#include <algorithm>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#	include <linux/io_uring.h>
+
+#	include <atomic>
+#	include <cerrno>
+#	include <chrono>
+#	include <cstring>
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+
+// Linked requests only have their file looked up when they are issued since
+// IORING_FEAT_LINKED_FILE, which is what lets a write use a file opened by the
+// request before it in the same chain.
+#	if defined(IORING_FEAT_LINKED_FILE) && defined(__NR_io_uring_setup)
+#		define SE_IO_URING
+#	endif
+#endif
+
+namespace SourceExplorer
+{
+	file_writer_t::~file_writer_t()
+	{
+		{
+			std::lock_guard lock(_mutex);
+			_stopping = true;
+		}
+		_wake.notify_all();
+		for (auto &thread : _threads) thread.join();
+	}
+
+	bool file_writer_t::write_now(const request_t &request)
+	{
+		DEBUG("Saving '", lak::to_u8string(request.path), "'");
+		if (!lak::save_file(request.path, request.data))
+		{
+			ERROR("Failed To Save File '", request.path, "'");
+			return false;
+		}
+		return true;
+	}
+
+	void file_writer_t::write(std::filesystem::path path,
+	                          lak::array<byte_t> data,
+	                          done_t done)
+	{
+		request_t request{.path = lak::move(path),
+		                  .data = lak::move(data),
+		                  .done = lak::move(done)};
+
+		if (_threads.empty())
+		{
+			const bool written = write_now(request);
+			if (request.done) request.done(written);
+			return;
+		}
+
+		{
+			std::lock_guard lock(_mutex);
+			_requests.push_back(lak::move(request));
+		}
+		_wake.notify_one();
+	}
+
+	void file_writer_t::thread_loop()
+	{
+		for (;;)
+		{
+			request_t request;
+			{
+				std::unique_lock lock(_mutex);
+				_wake.wait(lock, [&] { return !_requests.empty() || _stopping; });
+				if (_requests.empty()) break;
+				request = lak::move(_requests.front());
+				_requests.pop_front();
+			}
+
+			const bool written = write_now(request);
+			if (request.done) request.done(written);
+		}
+	}
+
+#ifdef SE_IO_URING
+	// The submission and completion rings shared with the kernel, plus a table
+	// of fixed file slots. Each file gets a slot for as long as it is in flight
+	// so its open, write and close can be queued together before the file
+	// exists.
+	struct file_writer_t::ring_t
+	{
+		int fd = -1;
+		unsigned slots = 0;
+
+		void *sq_ring       = MAP_FAILED;
+		size_t sq_ring_size = 0;
+		void *cq_ring       = MAP_FAILED;
+		size_t cq_ring_size = 0;
+		io_uring_sqe *sqes  = static_cast<io_uring_sqe *>(MAP_FAILED);
+		size_t sqes_size    = 0;
+
+		unsigned *sq_head  = nullptr;
+		unsigned *sq_tail  = nullptr;
+		unsigned *sq_mask  = nullptr;
+		unsigned *sq_array = nullptr;
+		// Requests are only made visible to the kernel by enter.
+		unsigned next_tail = 0;
+		unsigned *cq_head  = nullptr;
+		unsigned *cq_tail  = nullptr;
+		unsigned *cq_mask  = nullptr;
+		io_uring_cqe *cqes = nullptr;
+
+		ring_t() = default;
+
+		ring_t(const ring_t &)            = delete;
+		ring_t &operator=(const ring_t &) = delete;
+
+		~ring_t()
+		{
+			if (sqes != MAP_FAILED) munmap(sqes, sqes_size);
+			if (cq_ring != MAP_FAILED && cq_ring != sq_ring)
+				munmap(cq_ring, cq_ring_size);
+			if (sq_ring != MAP_FAILED) munmap(sq_ring, sq_ring_size);
+			if (fd >= 0) ::close(fd);
+		}
+
+		// Fails if the kernel is too old, or io_uring has been disabled or
+		// filtered out (as it often is in containers).
+		bool setup(unsigned slot_count)
+		{
+			io_uring_params params = {};
+			// 3 requests per file. The completion ring is twice as big by default
+			// so it can never overflow.
+			fd = int(syscall(__NR_io_uring_setup, slot_count * 3, &params));
+			if (fd < 0) return false;
+
+			if (!(params.features & IORING_FEAT_LINKED_FILE)) return false;
+
+			sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+			cq_ring_size =
+			  params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+			if (single_mmap)
+				sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+
+			sq_ring = mmap(nullptr,
+			               sq_ring_size,
+			               PROT_READ | PROT_WRITE,
+			               MAP_SHARED | MAP_POPULATE,
+			               fd,
+			               IORING_OFF_SQ_RING);
+			if (sq_ring == MAP_FAILED) return false;
+
+			cq_ring = single_mmap ? sq_ring
+			                      : mmap(nullptr,
+			                             cq_ring_size,
+			                             PROT_READ | PROT_WRITE,
+			                             MAP_SHARED | MAP_POPULATE,
+			                             fd,
+			                             IORING_OFF_CQ_RING);
+			if (cq_ring == MAP_FAILED) return false;
+
+			sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+			void *sqe_map = mmap(nullptr,
+			                     sqes_size,
+			                     PROT_READ | PROT_WRITE,
+			                     MAP_SHARED | MAP_POPULATE,
+			                     fd,
+			                     IORING_OFF_SQES);
+			if (sqe_map == MAP_FAILED) return false;
+			sqes = static_cast<io_uring_sqe *>(sqe_map);
+
+			auto *sq = static_cast<byte_t *>(sq_ring);
+			auto *cq = static_cast<byte_t *>(cq_ring);
+			sq_head  = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+			sq_tail  = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+			sq_mask  = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+			sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+			cq_head  = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+			cq_tail  = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+			cq_mask  = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+			cqes     = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+			next_tail = *sq_tail;
+
+			// -1 leaves a slot empty for openat to fill in.
+			lak::array<int> files;
+			files.resize(slot_count);
+			std::fill(files.begin(), files.end(), -1);
+			if (syscall(__NR_io_uring_register,
+			            fd,
+			            IORING_REGISTER_FILES,
+			            files.data(),
+			            slot_count) < 0)
+				return false;
+
+			slots = slot_count;
+			return true;
+		}
+
+		// There is always room, at most 3 requests per slot are ever queued.
+		io_uring_sqe &next_sqe()
+		{
+			const unsigned index = next_tail++ & *sq_mask;
+			sq_array[index]      = index;
+			std::memset(&sqes[index], 0, sizeof(io_uring_sqe));
+			return sqes[index];
+		}
+
+		int enter(unsigned submit, unsigned wait)
+		{
+			std::atomic_ref(*sq_tail).store(next_tail, std::memory_order_release);
+			return int(syscall(__NR_io_uring_enter,
+			                   fd,
+			                   submit,
+			                   wait,
+			                   wait ? IORING_ENTER_GETEVENTS : 0U,
+			                   nullptr,
+			                   0));
+		}
+	};
+
+	void file_writer_t::ring_loop(ring_t &ring)
+	{
+		enum : uint64_t
+		{
+			openat_op = 0,
+			write_op  = 1,
+			close_op  = 2,
+		};
+
+		struct flight_t
+		{
+			request_t request;
+			int results[3]     = {};
+			unsigned remaining = 0;
+			// Where the open was put in the submission ring.
+			unsigned first_sqe = 0;
+		};
+
+		lak::array<flight_t> flights;
+		flights.resize(ring.slots);
+		lak::array<unsigned> free_slots;
+		for (unsigned i = ring.slots; i-- > 0;) free_slots.push_back(i);
+		unsigned in_flight = 0;
+
+		auto queue = [&](unsigned slot)
+		{
+			flight_t &flight       = flights[slot];
+			const request_t &req   = flight.request;
+			const uint64_t user_id = uint64_t(slot) << 2;
+			flight.remaining       = 3;
+			flight.first_sqe       = ring.next_tail;
+			// Anything that never completes counts as failed.
+			std::fill(std::begin(flight.results), std::end(flight.results), -1);
+
+			DEBUG("Saving '", lak::to_u8string(req.path), "'");
+
+			// O_CLOEXEC means nothing for a fixed file, and is refused.
+			io_uring_sqe &open = ring.next_sqe();
+			open.opcode        = IORING_OP_OPENAT;
+			open.flags         = IOSQE_IO_LINK;
+			open.fd            = AT_FDCWD;
+			open.addr          = reinterpret_cast<uintptr_t>(req.path.c_str());
+			open.len           = 0666;
+			open.open_flags    = O_WRONLY | O_CREAT | O_TRUNC;
+			open.file_index    = slot + 1;
+			open.user_data     = user_id | openat_op;
+
+			// A hard link so the close still happens if the write fails.
+			io_uring_sqe &write = ring.next_sqe();
+			write.opcode        = IORING_OP_WRITE;
+			write.flags         = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+			write.fd            = int(slot);
+			write.addr          = reinterpret_cast<uintptr_t>(req.data.data());
+			write.len           = unsigned(req.data.size());
+			write.off           = 0;
+			write.user_data     = user_id | write_op;
+
+			io_uring_sqe &close = ring.next_sqe();
+			close.opcode        = IORING_OP_CLOSE;
+			close.file_index    = slot + 1;
+			close.user_data     = user_id | close_op;
+		};
+
+		auto complete = [&](unsigned slot)
+		{
+			flight_t &flight = flights[slot];
+			request_t request{lak::move(flight.request)};
+			const bool written =
+			  flight.results[openat_op] >= 0 &&
+			  size_t(flight.results[write_op]) == request.data.size() &&
+			  flight.results[close_op] >= 0;
+
+			free_slots.push_back(slot);
+			--in_flight;
+
+			// Short writes and anything else unexpected get one more go the slow
+			// way, which also reports the failure properly.
+			const bool result = written || write_now(request);
+			if (request.done) request.done(result);
+		};
+
+		auto reap = [&]
+		{
+			unsigned head       = *ring.cq_head;
+			const unsigned tail = std::atomic_ref(*ring.cq_tail).load(
+			  std::memory_order_acquire);
+			for (; head != tail; ++head)
+			{
+				const io_uring_cqe &cqe = ring.cqes[head & *ring.cq_mask];
+				const unsigned slot     = unsigned(cqe.user_data >> 2);
+				flights[slot].results[cqe.user_data & 3] = cqe.res;
+				std::atomic_ref(*ring.cq_head).store(head + 1,
+				                                     std::memory_order_release);
+				if (--flights[slot].remaining == 0) complete(slot);
+			}
+		};
+
+		// Once io_uring_enter fails for real (e.g. ENOMEM) the ring is given up
+		// on. Requests the kernel never saw are written the slow way straight
+		// away, the rest still have to wait for the kernel to be done with their
+		// buffers.
+		auto abandon = [&]
+		{
+			ERROR("io_uring_enter failed: ",
+			      std::strerror(errno),
+			      ", falling back to writer threads");
+
+			// Without SQPOLL the kernel only reads the submission ring inside
+			// io_uring_enter, so whatever it hasn't taken yet can be withdrawn.
+			const unsigned head =
+			  std::atomic_ref(*ring.sq_head).load(std::memory_order_acquire);
+			const unsigned withdrawn = ring.next_tail - head;
+			ring.next_tail           = head;
+			std::atomic_ref(*ring.sq_tail).store(head, std::memory_order_release);
+
+			for (unsigned slot = 0; slot < ring.slots; ++slot)
+			{
+				flight_t &flight = flights[slot];
+				if (flight.remaining == 0) continue;
+
+				// Requests are taken in order, so a chain may have been cut short.
+				unsigned taken = 0;
+				for (unsigned i = 0; i < 3; ++i)
+					if (flight.first_sqe + i - head >= withdrawn) ++taken;
+
+				const unsigned completed = 3 - flight.remaining;
+				flight.remaining         = taken - completed;
+				if (flight.remaining == 0) complete(slot);
+			}
+
+			while (in_flight > 0)
+			{
+				if (ring.enter(0, 1) < 0 && errno != EINTR)
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				reap();
+			}
+		};
+
+		bool abandoned = false;
+		while (!abandoned)
+		{
+			unsigned to_submit = 0;
+			bool queued        = false;
+			lak::array<request_t> too_big;
+			{
+				std::unique_lock lock(_mutex);
+				_wake.wait(lock,
+				           [&]
+				           {
+					           return in_flight > 0 || !_requests.empty() ||
+					                  _stopping;
+				           });
+				if (in_flight == 0 && _requests.empty()) break;
+
+				// Everything that has queued up since the last time around goes
+				// in as one batch.
+				while (!_requests.empty() && !free_slots.empty())
+				{
+					if (_requests.front().data.size() > 0x7FFFF000U)
+					{
+						// Too big for a single write.
+						too_big.push_back(lak::move(_requests.front()));
+						_requests.pop_front();
+						continue;
+					}
+					const unsigned slot   = free_slots.back();
+					flights[slot].request = lak::move(_requests.front());
+					_requests.pop_front();
+					free_slots.pop_back();
+					queue(slot);
+					++in_flight;
+					to_submit += 3;
+					queued = true;
+				}
+			}
+
+			for (auto &request : too_big)
+			{
+				const bool written = write_now(request);
+				if (request.done) request.done(written);
+			}
+
+			while (to_submit > 0 && !abandoned)
+			{
+				const int submitted = ring.enter(to_submit, 0);
+				if (submitted >= 0)
+				{
+					to_submit -= unsigned(submitted);
+				}
+				else if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+				{
+					reap();
+				}
+				else
+				{
+					abandon();
+					abandoned = true;
+				}
+			}
+			if (abandoned) break;
+
+			// Nothing new could be handed over, so sleep until something finishes.
+			// Requests that arrive in the mean time go in with the next batch.
+			if (!queued && in_flight > 0 && ring.enter(0, 1) < 0 && errno != EINTR)
+			{
+				abandon();
+				abandoned = true;
+			}
+
+			reap();
+		}
+
+		if (!abandoned) return;
+
+		// Carry on as the threads sink, with this thread as one of the writers.
+		_sink = file_sink_t::threads;
+		lak::array<std::thread> threads;
+		threads.reserve(_thread_count - 1);
+		for (size_t i = 1; i < _thread_count; ++i)
+			threads.emplace_back([this] { thread_loop(); });
+		thread_loop();
+		for (auto &thread : threads) thread.join();
+	}
+#endif
+
+	lak::shared_ptr<file_writer_t> file_writer_t::open(file_sink_t sink,
+	                                                   size_t thread_count)
+	{
+		auto result           = lak::shared_ptr<file_writer_t>::make();
+		result->_sink         = sink;
+		result->_thread_count = std::max<size_t>(thread_count, 1U);
+
+		if (sink == file_sink_t::io_uring)
+		{
+#ifdef SE_IO_URING
+			// How many files may be in flight at once.
+			static constexpr unsigned ring_slots = 64;
+
+			auto ring = lak::unique_ptr<ring_t>::make();
+			if (ring->setup(ring_slots))
+			{
+				file_writer_t *writer = &*result;
+				writer->_threads.emplace_back(
+				  [writer, ring = lak::move(ring)] { writer->ring_loop(*ring); });
+				return result;
+			}
+#endif
+			WARNING("io_uring is not available, falling back to writer threads");
+			result->_sink = file_sink_t::threads;
+		}
+
+		if (result->_sink == file_sink_t::threads)
+		{
+			file_writer_t *writer = &*result;
+			writer->_threads.reserve(writer->_thread_count);
+			for (size_t i = 0; i < writer->_thread_count; ++i)
+				writer->_threads.emplace_back([writer] { writer->thread_loop(); });
+		}
+
+		return result;
+	}
+}
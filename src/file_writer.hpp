@@ -0,0 +1,91 @@
+#ifndef SRCEXP_FILE_WRITER_HPP
+#define SRCEXP_FILE_WRITER_HPP
+
+#include <lak/array.hpp>
+#include <lak/memory.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace SourceExplorer
+{
+	enum struct file_sink_t : uint8_t
+	{
+		// Files are written on the calling thread.
+		sync     = 0,
+		// Files are handed to a pool of threads that only write files.
+		threads  = 1,
+		// Files are handed to a single thread that batches their open, write and
+		// close through io_uring. Falls back to threads where io_uring isn't
+		// available.
+		io_uring = 2,
+	};
+
+	static constexpr size_t file_sink_count = 3;
+
+	// Writes whole files out so whoever made them doesn't have to wait for the
+	// file system, which can be very slow for lots of small files on network
+	// mounts.
+	struct file_writer_t
+	{
+		// Called with whether the file was written, from one of the writer's
+		// own threads unless the sink is sync.
+		using done_t = std::function<void(bool)>;
+
+	private:
+		struct request_t
+		{
+			std::filesystem::path path;
+			lak::array<byte_t> data;
+			done_t done;
+		};
+
+		struct ring_t;
+
+		// Only changes after open if io_uring fails and the ring thread falls
+		// back to the threads sink.
+		std::atomic<file_sink_t> _sink = file_sink_t::sync;
+		size_t _thread_count           = 1;
+
+		std::mutex _mutex;
+		std::condition_variable _wake;
+		// Guarded by _mutex.
+		std::deque<request_t> _requests;
+		bool _stopping = false;
+
+		lak::array<std::thread> _threads;
+
+		static bool write_now(const request_t &request);
+		void thread_loop();
+		void ring_loop(ring_t &ring);
+
+	public:
+		file_writer_t() = default;
+
+		file_writer_t(const file_writer_t &)            = delete;
+		file_writer_t &operator=(const file_writer_t &) = delete;
+
+		// Finishes writing everything that has been handed over first.
+		~file_writer_t();
+
+		// thread_count is only used by the threads sink, and by the io_uring
+		// sink when it has to fall back.
+		static lak::shared_ptr<file_writer_t> open(file_sink_t sink,
+		                                           size_t thread_count);
+
+		// The sink actually in use, which may differ from the one asked for (and
+		// may change from io_uring to threads after a write).
+		file_sink_t sink() const { return _sink; }
+
+		void write(std::filesystem::path path,
+		           lak::array<byte_t> data,
+		           done_t done);
+	};
+}
+
+#endif
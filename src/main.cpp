@@ -42,6 +42,9 @@
 #include <lak/test.hpp>
 #include <lak/window.hpp>
 
+#include <charconv>
+#include <cstring>
+
 #ifndef MAXDIRLEN
 #	define MAXDIRLEN 512
 #endif
@@ -107,6 +110,18 @@ ImGui::ImplContext imgui_context = nullptr;
 
 bool force_only_error = false;
 
+// Parses the whole of arg as a count of unit sized things, for flag.
+static size_t ParseSizeArg(const char *flag, const char *arg, size_t unit = 1)
+{
+	size_t value         = 0;
+	const char *end      = arg + std::strlen(arg);
+	const auto [ptr, ec] = std::from_chars(arg, end, value);
+	if (ptr == arg || ptr != end || ec != std::errc{})
+		FATAL("Invalid ", flag, " '", arg, "'");
+	if (value > SIZE_MAX / unit) FATAL(flag, " '", arg, "' is too large");
+	return value * unit;
+}
+
 lak::optional<int> basic_window_preinit(int argc, char **argv)
 {
 	if (argc == 2 && argv[1] == lak::astring("--version"))
@@ -129,7 +144,13 @@ lak::optional<int> basic_window_preinit(int argc, char **argv)
 			std::cout << "srcexp.exe [--help] [--nogl] [--onlyerr] "
 			             "[--listtests | --laktestall | --laktests \"test1;test2\"] "
 			             "[--test] [--skip-broken] [--open-broken] [--threaded] "
-			             "[--analyse] [<filepath>]\n";
+			             "[--no-mmap] [--mmap-budget <MiB>] [--decode-cache <MiB>] "
+			             "[--parallel-inflate <MiB>] "
+			             "[--eager-banks] [--parallel-banks] [--stream-dumps] "
+			             "[--dump-items <count>] [--dump-budget <MiB>] "
+			             "[--dump-sink <sync|threads|io_uring>] "
+			             "[--analyse] "
+			             "[<filepath>]\n";
 			return lak::optional<int>(0);
 		}
 		else if (argv[arg] == lak::astring("--nogl"))
@@ -182,6 +203,73 @@ lak::optional<int> basic_window_preinit(int argc, char **argv)
 		{
 			SrcExp.allow_multithreading = true;
 		}
+		else if (argv[arg] == lak::astring("--no-mmap"))
+		{
+			se::memory_map_files = false;
+		}
+		else if (argv[arg] == lak::astring("--mmap-budget"))
+		{
+			++arg;
+			if (arg >= argc) FATAL("Missing budget");
+			se::mapped_file_budget =
+			  ParseSizeArg("--mmap-budget", argv[arg], 0x100000);
+		}
+		else if (argv[arg] == lak::astring("--decode-cache"))
+		{
+			++arg;
+			if (arg >= argc) FATAL("Missing budget");
+			se::decode_cache_budget =
+			  ParseSizeArg("--decode-cache", argv[arg], 0x100000);
+		}
+		else if (argv[arg] == lak::astring("--parallel-inflate"))
+		{
+			++arg;
+			if (arg >= argc) FATAL("Missing threshold");
+			se::parallel_inflate_threshold =
+			  ParseSizeArg("--parallel-inflate", argv[arg], 0x100000);
+#ifndef SE_FAST_INFLATE
+			WARNING("--parallel-inflate is ignored without the fast inflate "
+			        "engine (-Dinflate_engine=fast)");
+#endif
+		}
+		else if (argv[arg] == lak::astring("--eager-banks"))
+		{
+			se::lazy_load_banks = false;
+		}
+		else if (argv[arg] == lak::astring("--parallel-banks"))
+		{
+			se::parallel_load_banks = true;
+		}
+		else if (argv[arg] == lak::astring("--stream-dumps"))
+		{
+			se::stream_dumps = true;
+		}
+		else if (argv[arg] == lak::astring("--dump-items"))
+		{
+			++arg;
+			if (arg >= argc) FATAL("Missing count");
+			se::dump_item_limit = ParseSizeArg("--dump-items", argv[arg]);
+		}
+		else if (argv[arg] == lak::astring("--dump-budget"))
+		{
+			++arg;
+			if (arg >= argc) FATAL("Missing budget");
+			se::dump_byte_limit =
+			  ParseSizeArg("--dump-budget", argv[arg], 0x100000);
+		}
+		else if (argv[arg] == lak::astring("--dump-sink"))
+		{
+			++arg;
+			if (arg >= argc) FATAL("Missing sink");
+			if (argv[arg] == lak::astring("sync"))
+				se::dump_sink = se::file_sink_t::sync;
+			else if (argv[arg] == lak::astring("threads"))
+				se::dump_sink = se::file_sink_t::threads;
+			else if (argv[arg] == lak::astring("io_uring"))
+				se::dump_sink = se::file_sink_t::io_uring;
+			else
+				FATAL("Unknown sink '", argv[arg], "'");
+		}
 		else
 		{
 			SrcExp.baby_mode   = false;
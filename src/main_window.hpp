@@ -149,6 +149,14 @@ struct main_window : public base_window<main_window>
 			ImGui::Checkbox("Force compat mode", &se::force_compat);
 			ImGui::Checkbox("Skip broken items", &se::skip_broken_items);
 			ImGui::Checkbox("Open broken games", &se::open_broken_games);
+			ImGui::Checkbox("Memory map files", &se::memory_map_files);
+			ImGui::Checkbox("Lazy load banks", &se::lazy_load_banks);
+			ImGui::Checkbox("Parallel load banks", &se::parallel_load_banks);
+			ImGui::Checkbox("Stream dumps", &se::stream_dumps);
+			int sink = static_cast<int>(se::dump_sink);
+			if (ImGui::Combo(
+			      "Dump writer", &sink, "Synchronous\0Threads\0io_uring\0"))
+				se::dump_sink = static_cast<se::file_sink_t>(sink);
 			ImGui::Checkbox("Enable multithreading", &SrcExp.allow_multithreading);
 			ImGui::EndMenu();
 		}
@@ -300,30 +308,41 @@ struct main_window : public base_window<main_window>
 		}
 
 		if (SrcExp.exe.attempt)
+		{
 			se::AttemptExe(SrcExp);
-		else if (SrcExp.images.attempt)
-			se::AttemptImages(SrcExp);
-		else if (SrcExp.sorted_images.attempt)
+		}
+		else
 		{
-			if (SrcExp.state.two_five_plus_game)
-				SrcExp.sorted_images.attempt = false;
-			else
-				se::AttemptSortedImages(SrcExp);
+			if (SrcExp.state.two_five_plus_game) SrcExp.sorted_images.attempt = false;
+
+			// Dumps that already have somewhere to go all run at once, but only one
+			// file dialog can be open at a time.
+			bool dialog_open = false;
+			auto attempt =
+			  [&](se::file_state_t &file_state, void (*func)(se::source_explorer_t &))
+			{
+				if (!file_state.attempt) return;
+				if (!file_state.valid)
+				{
+					if (dialog_open) return;
+					dialog_open = true;
+				}
+				func(SrcExp);
+			};
+
+			attempt(SrcExp.images, &se::AttemptImages);
+			attempt(SrcExp.sorted_images, &se::AttemptSortedImages);
+			attempt(SrcExp.appicon, &se::AttemptAppIcon);
+			attempt(SrcExp.sounds, &se::AttemptSounds);
+			attempt(SrcExp.music, &se::AttemptMusic);
+			attempt(SrcExp.shaders, &se::AttemptShaders);
+			attempt(SrcExp.binary_files, &se::AttemptBinaryFiles);
+			attempt(SrcExp.error_log, &se::AttemptErrorLog);
+			attempt(SrcExp.binary_block, &se::AttemptBinaryBlock);
+
+			// Opening the progress popup would close the dialog.
+			if (!dialog_open) se::DumpProgress();
 		}
-		else if (SrcExp.appicon.attempt)
-			se::AttemptAppIcon(SrcExp);
-		else if (SrcExp.sounds.attempt)
-			se::AttemptSounds(SrcExp);
-		else if (SrcExp.music.attempt)
-			se::AttemptMusic(SrcExp);
-		else if (SrcExp.shaders.attempt)
-			se::AttemptShaders(SrcExp);
-		else if (SrcExp.binary_files.attempt)
-			se::AttemptBinaryFiles(SrcExp);
-		else if (SrcExp.error_log.attempt)
-			se::AttemptErrorLog(SrcExp);
-		else if (SrcExp.binary_block.attempt)
-			se::AttemptBinaryBlock(SrcExp);
 	}
 };
 
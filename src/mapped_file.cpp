@@ -0,0 +1,275 @@
+#include "mapped_file.hpp"
+
+#include <lak/debug.hpp>
+
+#include <algorithm>
+
+#ifdef _WIN32
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace SourceExplorer
+{
+#ifdef _WIN32
+	mapped_file_t::~mapped_file_t()
+	{
+		if (_view.data()) UnmapViewOfFile(_view.data());
+		if (_mapping) CloseHandle(_mapping);
+	}
+
+	lak::result<lak::shared_ptr<mapped_file_t>> mapped_file_t::open(
+	  const std::filesystem::path &path,
+	  size_t window_size,
+	  size_t resident_budget)
+	{
+		HANDLE file = CreateFileW(path.c_str(),
+		                          GENERIC_READ,
+		                          FILE_SHARE_READ,
+		                          nullptr,
+		                          OPEN_EXISTING,
+		                          FILE_ATTRIBUTE_NORMAL,
+		                          nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			WARNING("Failed to open ", path, " for mapping");
+			return lak::err_t{};
+		}
+		DEFER(CloseHandle(file));
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0 ||
+		    uint64_t(file_size.QuadPart) > SIZE_MAX)
+			return lak::err_t{};
+
+		auto result = lak::shared_ptr<mapped_file_t>::make();
+
+		result->_mapping =
+		  CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+		if (!result->_mapping)
+		{
+			WARNING("Failed to create file mapping for ", path);
+			return lak::err_t{};
+		}
+
+		void *view = MapViewOfFile(result->_mapping, FILE_MAP_COPY, 0, 0, 0);
+		if (!view)
+		{
+			WARNING("Failed to map view of ", path);
+			return lak::err_t{};
+		}
+
+		result->_view = lak::span<byte_t>(static_cast<byte_t *>(view),
+		                                  size_t(file_size.QuadPart));
+
+		result->set_residency(window_size, resident_budget);
+
+		return lak::ok_t{lak::move(result)};
+	}
+
+	void mapped_file_t::advise(access_pattern_t) const
+	{
+		// Windows has no equivalent of madvise for mapped views, the cache
+		// manager already detects sequential access on its own.
+	}
+
+	void mapped_file_t::prefetch_window(size_t) const {}
+
+	void mapped_file_t::release_window(size_t window) const
+	{
+		const auto pages{window_span(window)};
+		// Unlocking pages that aren't locked removes them from the working set.
+		VirtualUnlock(pages.data(), pages.size());
+	}
+#else
+	mapped_file_t::~mapped_file_t()
+	{
+		if (_view.data()) munmap(_view.data(), _view.size());
+	}
+
+	lak::result<lak::shared_ptr<mapped_file_t>> mapped_file_t::open(
+	  const std::filesystem::path &path,
+	  size_t window_size,
+	  size_t resident_budget)
+	{
+		const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			WARNING("Failed to open ", path, " for mapping");
+			return lak::err_t{};
+		}
+		DEFER(::close(fd));
+
+		struct stat file_stat;
+		if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0 ||
+		    uint64_t(file_stat.st_size) > SIZE_MAX)
+			return lak::err_t{};
+
+		const size_t size = size_t(file_stat.st_size);
+
+		// PROT_WRITE + MAP_PRIVATE gives copy-on-write pages, the file is only
+		// ever opened for reading.
+		void *view =
+		  mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		if (view == MAP_FAILED)
+		{
+			WARNING("Failed to map ", path);
+			return lak::err_t{};
+		}
+
+		auto result   = lak::shared_ptr<mapped_file_t>::make();
+		result->_view = lak::span<byte_t>(static_cast<byte_t *>(view), size);
+
+		result->set_residency(window_size, resident_budget);
+
+		return lak::ok_t{lak::move(result)};
+	}
+
+	void mapped_file_t::advise(access_pattern_t pattern) const
+	{
+		if (_view.empty()) return;
+
+		int advice = MADV_NORMAL;
+		switch (pattern)
+		{
+			case access_pattern_t::sequential:
+				advice = MADV_SEQUENTIAL;
+				break;
+			case access_pattern_t::random:
+				advice = MADV_RANDOM;
+				break;
+			default:
+				break;
+		}
+
+		if (madvise(_view.data(), _view.size(), advice) != 0)
+			WARNING("madvise failed");
+	}
+
+	void mapped_file_t::prefetch_window(size_t window) const
+	{
+		const auto pages{window_span(window)};
+		madvise(pages.data(), pages.size(), MADV_WILLNEED);
+	}
+
+	void mapped_file_t::release_window(size_t window) const
+	{
+		const auto pages{window_span(window)};
+		// Dropped pages are re-read from the file on the next access. This is
+		// never called for written windows, their copy-on-write pages would
+		// revert to the contents of the file.
+		if (madvise(pages.data(), pages.size(), MADV_DONTNEED) != 0)
+			WARNING("madvise failed");
+	}
+#endif
+
+	void mapped_file_t::set_residency(size_t window_size,
+	                                  size_t resident_budget)
+	{
+		if (window_size == 0 || resident_budget == 0) return;
+
+		// Keep windows aligned to the largest page/allocation granularity we
+		// care about.
+		constexpr size_t granularity = 0x10000;
+		_window_size =
+		  ((window_size + granularity - 1) / granularity) * granularity;
+		_max_windows = std::max<size_t>(1, resident_budget / _window_size);
+		_windows.resize((_view.size() + _window_size - 1) / _window_size);
+	}
+
+	void mapped_file_t::unlink_window(size_t window) const
+	{
+		auto &node = _windows[window];
+		(node.prev == no_window ? _least_recent : _windows[node.prev].next) =
+		  node.next;
+		(node.next == no_window ? _most_recent : _windows[node.next].prev) =
+		  node.prev;
+		node.prev = node.next = no_window;
+	}
+
+	void mapped_file_t::append_window(size_t window) const
+	{
+		auto &node = _windows[window];
+		node.prev  = _most_recent;
+		node.next  = no_window;
+		(_most_recent == no_window ? _least_recent
+		                           : _windows[_most_recent].next) = window;
+		_most_recent = window;
+	}
+
+	lak::span<byte_t> mapped_file_t::window_span(size_t window) const
+	{
+		const size_t offset = window * _window_size;
+		return _view.subspan(offset,
+		                     std::min(_window_size, _view.size() - offset));
+	}
+
+	void mapped_file_t::touch(size_t offset, size_t count) const
+	{
+		if (_max_windows == 0 || count == 0 || offset >= _view.size()) return;
+
+		count              = std::min(count, _view.size() - offset);
+		const size_t first = offset / _window_size;
+		const size_t last  = (offset + count - 1) / _window_size;
+
+		// Spans bigger than the budget (such as the span over the entire file)
+		// would just evict themselves.
+		if (last - first + 1 > _max_windows) return;
+
+		// Already the most recently touched window. Racing with another touch
+		// can at worst let that one release this window early, it just gets
+		// faulted back in.
+		if (first == last && _last_touched.load(std::memory_order_relaxed) == last)
+			return;
+
+		std::lock_guard lock(_residency_mutex);
+
+		for (size_t window = first; window <= last; ++window)
+		{
+			auto &node = _windows[window];
+			if (node.resident)
+			{
+				// Move to the most recent end of the LRU list.
+				if (_most_recent == window) continue;
+				unlink_window(window);
+			}
+			else
+			{
+				prefetch_window(window);
+				node.resident = true;
+				++_resident_count;
+			}
+			append_window(window);
+		}
+
+		while (_resident_count > _max_windows)
+		{
+			const size_t window = _least_recent;
+			unlink_window(window);
+			_windows[window].resident = false;
+			--_resident_count;
+			// Written windows just leave the list and stay resident.
+			if (!_windows[window].written) release_window(window);
+		}
+
+		_last_touched.store(_most_recent, std::memory_order_relaxed);
+	}
+
+	void mapped_file_t::mark_written(size_t offset, size_t count) const
+	{
+		if (_max_windows == 0 || count == 0 || offset >= _view.size()) return;
+
+		count              = std::min(count, _view.size() - offset);
+		const size_t first = offset / _window_size;
+		const size_t last  = (offset + count - 1) / _window_size;
+
+		std::lock_guard lock(_residency_mutex);
+
+		for (size_t window = first; window <= last; ++window)
+			_windows[window].written = true;
+	}
+}
@@ -0,0 +1,109 @@
+#ifndef SRCEXP_MAPPED_FILE_HPP
+#define SRCEXP_MAPPED_FILE_HPP
+
+#include <lak/array.hpp>
+#include <lak/memory.hpp>
+#include <lak/result.hpp>
+#include <lak/span.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+
+namespace SourceExplorer
+{
+	enum struct access_pattern_t
+	{
+		normal,
+		sequential,
+		random,
+	};
+
+	// A file mapped into memory. The mapping is private (copy-on-write) so
+	// edits made through the view (e.g. from the memory explorer) never reach
+	// the file on disk.
+	//
+	// If a resident budget is set, the file is split into fixed size windows
+	// and the least recently touched windows are released back to the OS once
+	// more than budget bytes worth of windows have been touched. The view
+	// itself never moves, so spans into it stay valid, released pages are
+	// simply faulted back in from the file when they are next read.
+	//
+	// Only touched windows count towards the budget. data_ref_span_t touches
+	// the bytes it covers, data_reader_t::touch covers reads made straight
+	// through a reader. Windows that have been written to are never released,
+	// as that would throw the edits away.
+	struct mapped_file_t
+	{
+	private:
+		lak::span<byte_t> _view = {};
+#ifdef _WIN32
+		void *_mapping = nullptr;
+#endif
+
+		static constexpr size_t no_window = SIZE_MAX;
+
+		// An intrusive LRU list node for each window of the file, so touching
+		// and evicting a window is O(1).
+		struct window_t
+		{
+			// The neighbouring resident windows, less recently touched first.
+			size_t prev   = no_window;
+			size_t next   = no_window;
+			bool resident = false;
+			// Written windows are never released.
+			bool written  = false;
+		};
+
+		size_t _window_size = 0;
+		size_t _max_windows = 0;
+		mutable std::mutex _residency_mutex;
+		// Guarded by _residency_mutex.
+		mutable lak::array<window_t> _windows;
+		mutable size_t _least_recent   = no_window;
+		mutable size_t _most_recent    = no_window;
+		mutable size_t _resident_count = 0;
+		// A copy of _most_recent that can be checked without the lock, so
+		// repeatedly touching the same window doesn't have to take it.
+		mutable std::atomic_size_t _last_touched = no_window;
+
+		void set_residency(size_t window_size, size_t resident_budget);
+		void unlink_window(size_t window) const;
+		void append_window(size_t window) const;
+		lak::span<byte_t> window_span(size_t window) const;
+		void prefetch_window(size_t window) const;
+		void release_window(size_t window) const;
+
+	public:
+		mapped_file_t() = default;
+
+		mapped_file_t(const mapped_file_t &)            = delete;
+		mapped_file_t &operator=(const mapped_file_t &) = delete;
+
+		~mapped_file_t();
+
+		// Fails if the file is empty or the mapping could not be created, the
+		// caller is expected to fall back to reading the file into memory.
+		// A resident_budget of 0 disables residency tracking.
+		static lak::result<lak::shared_ptr<mapped_file_t>> open(
+		  const std::filesystem::path &path,
+		  size_t window_size     = 0,
+		  size_t resident_budget = 0);
+
+		inline lak::span<byte_t> view() const { return _view; }
+		inline size_t size() const { return _view.size(); }
+
+		// Hint to the OS how the mapping is about to be accessed.
+		void advise(access_pattern_t pattern) const;
+
+		// Mark [offset, offset + count) as about to be used, releasing the
+		// least recently used windows if this pushes us over budget.
+		void touch(size_t offset, size_t count) const;
+
+		// Mark [offset, offset + count) as having been written through the
+		// view, so it is kept resident from now on.
+		void mark_written(size_t offset, size_t count) const;
+	};
+}
+
+#endif